@@ -0,0 +1,130 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+
+namespace ArduinoWindowsHost
+{
+	namespace Benchmarks
+	{
+		/// <summary>
+		/// Minimal benchmark harness: times a body, prints its rate, and records failed checks.
+		/// - Quick mode scales workloads down for smoke runs under ctest; the full mode is for comparing numbers.
+		/// - Each suite validates what it measured (nothing dropped, everything decoded), so a regression
+		///   that breaks behaviour fails the run instead of just producing a faster number.
+		/// </summary>
+		class BenchmarkRunner
+		{
+		private:
+			using Clock = std::chrono::steady_clock;
+
+		private:
+			const bool Quick;
+			uint32_t Failures = 0;
+
+		public:
+			BenchmarkRunner(const bool quick)
+				: Quick(quick)
+			{
+			}
+
+			bool IsQuick() const
+			{
+				return Quick;
+			}
+
+			uint32_t GetFailures() const
+			{
+				return Failures;
+			}
+
+			// Workload size: count for full runs, a hundredth of it (at least 1) for quick runs.
+			uint32_t Scale(const uint32_t count) const
+			{
+				if (!Quick)
+					return count;
+				return count >= 100 ? count / 100 : 1;
+			}
+
+			/// <summary>
+			/// Runs body() once and prints operations per second and time per operation.
+			/// </summary>
+			/// <param name="operations">Operations body() performs, for the rate.</param>
+			/// <returns>Elapsed seconds.</returns>
+			template<typename F>
+			double Measure(const char* name, const uint64_t operations, F&& body)
+			{
+				const Clock::time_point start = Clock::now();
+				body();
+				const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+				const double rate = seconds > 0 ? operations / seconds : 0;
+				const double nanos = operations > 0 ? (seconds * 1e9) / operations : 0;
+				if (rate >= 1e6)
+					printf("  %-44s %10.2f M/s %12.1f ns\n", name, rate / 1e6, nanos);
+				else
+					printf("  %-44s %10.2f K/s %12.1f ns\n", name, rate / 1e3, nanos);
+				return seconds;
+			}
+
+			// Prints a throughput in MB/s for bytes moved over seconds.
+			void Report(const char* name, const uint64_t bytes, const double seconds)
+			{
+				printf("  %-44s %10.1f MB/s\n", name, seconds > 0 ? (bytes / seconds) / 1e6 : 0);
+			}
+
+			// Prints a single measured value.
+			void Report(const char* name, const double value, const char* unit)
+			{
+				printf("  %-44s %10.1f %s\n", name, value, unit);
+			}
+
+			// Records a failure when condition is false.
+			bool Check(const bool condition, const char* what)
+			{
+				if (!condition)
+				{
+					printf("  FAILED: %s\n", what);
+					Failures++;
+				}
+				return condition;
+			}
+
+			// Notes a benchmark that can't run here (missing OS feature), without failing.
+			void Skip(const char* name, const char* reason)
+			{
+				printf("  %-44s skipped (%s)\n", name, reason);
+			}
+
+			static double Seconds(const Clock::time_point start)
+			{
+				return std::chrono::duration<double>(Clock::now() - start).count();
+			}
+
+			static Clock::time_point Now()
+			{
+				return Clock::now();
+			}
+		};
+
+		// Keeps a value alive past the optimizer.
+		template<typename T>
+		static void DoNotOptimize(const T& value)
+		{
+			static volatile T sink;
+			sink = value;
+			(void)sink;
+		}
+
+		using SuiteFunction = void(*)(BenchmarkRunner&);
+
+		struct Suite
+		{
+			const char* Name;
+			const char* Description;
+			SuiteFunction Run;
+		};
+	}
+}
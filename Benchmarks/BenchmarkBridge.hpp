@@ -0,0 +1,288 @@
+#pragma once
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include <ArduinoWindowsHost.h>
+#include <Bridge/Capture/SerialCapture.hpp>
+#include <Bridge/Capture/SerialCaptureReader.hpp>
+
+#include "Benchmark.hpp"
+
+namespace ArduinoWindowsHost
+{
+	namespace Benchmarks
+	{
+		namespace Bridge
+		{
+			static constexpr size_t ChunkSize = 16 * 1024;
+
+			static void Link(BenchmarkRunner& runner)
+			{
+				Hal::ArduinoSerialPort source(0, 64, 1 << 16, 1 << 16, 1 << 16);
+				Hal::ArduinoSerialPort destination(1, 64, 1 << 16, 1 << 16, 1 << 16);
+				source.SetTxLineLog(false);
+				destination.begin();
+				destination.setTimeout(1000);
+
+				SerialLinkConfig config{};
+				config.FlowControl = true;
+				SerialLink link(source, destination, config);
+				link.Start();
+
+				std::vector<uint8_t> chunk(ChunkSize, 'x');
+				std::vector<uint8_t> received(ChunkSize);
+				const uint32_t chunks = runner.Scale(4096);
+				uint64_t bytes = 0;
+				const double seconds = runner.Measure("SerialLink, 16 KB chunks", chunks, [&]()
+					{
+						for (uint32_t i = 0; i < chunks; i++)
+						{
+							source.write(chunk.data(), chunk.size());
+							size_t got = 0;
+							while (got < ChunkSize)
+							{
+								const size_t read = destination.readBytes(received.data() + got, ChunkSize - got);
+								if (read == 0)
+									return;
+								got += read;
+							}
+							bytes += got;
+						}
+					});
+				link.Stop();
+				runner.Report("  link", bytes, seconds);
+				runner.Check(bytes == uint64_t(chunks) * ChunkSize && link.GetBytesDropped() == 0, "link lossless");
+			}
+
+			static void Capture(BenchmarkRunner& runner)
+			{
+				static const char* path = "ArduinoWindowsHostBenchmark.capture";
+
+				Hal::ArduinoSerialPort first(0, 1024, 1 << 16, 1 << 16, 0);
+				Hal::ArduinoSerialPort second(1, 1024, 1 << 16, 1 << 16, 0);
+
+				const uint32_t lines = runner.Scale(2000000);
+				{
+					SerialCapture capture;
+					if (!runner.Check(capture.Open(path), "capture log created"))
+						return;
+					capture.Attach(first);
+					capture.Attach(second);
+
+					runner.Measure("println() captured, 2 ports", lines, [&]()
+						{
+							for (uint32_t i = 0; i < lines; i++)
+							{
+								if (i & 1)
+									second.println(i);
+								else
+									first.println(i);
+							}
+						});
+					capture.Close();
+					runner.Check(capture.GetRecords() == lines && capture.GetDroppedRecords() == 0, "capture lossless");
+				}
+
+				SerialCaptureReader reader;
+				runner.Measure("SerialCaptureReader::Open() (index)", lines, [&]()
+					{
+						reader.Open(path);
+					});
+				runner.Check(reader.GetLineCount() == lines, "all lines indexed");
+
+				const uint32_t seeks = runner.Scale(100000);
+				uint32_t found = 0;
+				runner.Measure("FindLine() + visit()", seeks, [&]()
+					{
+						for (uint32_t i = 0; i < seeks; i++)
+						{
+							const uint64_t line = (uint64_t(i) * 7919) % lines;
+							reader.visit(reader.FindLine(line), line, [&](const SerialCaptureReader::Record& record)
+								{
+									found += record.LineNumber == line && strtoul(record.Data, nullptr, 10) == line;
+									return false;
+								});
+						}
+					});
+				runner.Check(found == seeks, "seeks land on their line");
+
+				reader.Close();
+				remove(path);
+			}
+
+#if defined(__linux__)
+			static void Pty(BenchmarkRunner& runner)
+			{
+				Hal::ArduinoSerialPort port(0, 64, 1 << 16, 1 << 16, 1 << 18);
+				port.SetTxLineLog(false);
+				port.begin();
+
+				PtyBridge bridge(port);
+				if (!bridge.Open())
+				{
+					runner.Skip("PtyBridge", "no pseudo-terminals");
+					return;
+				}
+
+				const int fd = open(bridge.GetPath().c_str(), O_RDWR | O_NOCTTY);
+				termios attributes;
+				tcgetattr(fd, &attributes);
+				cfmakeraw(&attributes);
+				tcsetattr(fd, TCSANOW, &attributes);
+
+				std::vector<uint8_t> chunk(ChunkSize, 'p');
+				std::vector<uint8_t> received(ChunkSize);
+				const uint32_t chunks = runner.Scale(4096);
+				uint64_t bytes = 0;
+				const double seconds = runner.Measure("PtyBridge TX, 16 KB chunks", chunks, [&]()
+					{
+						for (uint32_t i = 0; i < chunks; i++)
+						{
+							port.write(chunk.data(), chunk.size());
+							size_t got = 0;
+							while (got < ChunkSize)
+							{
+								const ssize_t read = ::read(fd, received.data() + got, ChunkSize - got);
+								if (read <= 0)
+									return;
+								got += static_cast<size_t>(read);
+							}
+							bytes += got;
+						}
+					});
+				runner.Report("  pty", bytes, seconds);
+				runner.Check(bytes == uint64_t(chunks) * ChunkSize && port.GetTxRawDropped() == 0, "pty TX lossless");
+
+				const uint32_t echoes = runner.Scale(20000);
+				uint32_t answered = 0;
+				runner.Measure("PtyBridge echo round trip", echoes, [&]()
+					{
+						for (uint32_t i = 0; i < echoes; i++)
+						{
+							const uint32_t rxId = port.GetRxId();
+							const char value = static_cast<char>('a' + (i % 26));
+							if (::write(fd, &value, 1) != 1)
+								return;
+							int echoed;
+							while ((echoed = port.read()) < 0)
+								port.waitForRx(rxId, 100);
+							port.write(static_cast<uint8_t>(echoed));
+
+							char back;
+							if (::read(fd, &back, 1) == 1 && back == value)
+								answered++;
+						}
+					});
+				runner.Check(answered == echoes, "pty echoes");
+
+				close(fd);
+				bridge.Close();
+			}
+
+			static void SharedMemory(BenchmarkRunner& runner)
+			{
+				static const char* name = "/ArduinoWindowsHostBenchmark";
+
+				Hal::ArduinoSerialPort port(0, 64, 1 << 16, 1 << 16, 1 << 20);
+				port.SetTxLineLog(false);
+				port.begin();
+				port.setTimeout(1000);
+
+				SharedSerialServer server(port);
+				SharedSerialClient client;
+				if (!server.Open(name) || !client.Open(name))
+				{
+					runner.Skip("SharedSerialServer", "no POSIX shared memory");
+					return;
+				}
+
+				std::vector<uint8_t> chunk(ChunkSize, 's');
+				const uint32_t chunks = runner.Scale(16384);
+				uint64_t bytes = 0;
+				double seconds = runner.Measure("shared memory TX, 16 KB chunks", chunks, [&]()
+					{
+						for (uint32_t i = 0; i < chunks; i++)
+						{
+							port.write(chunk.data(), chunk.size());
+							size_t got = 0;
+							while (got < ChunkSize)
+							{
+								const size_t drained = client.drain([](const uint8_t*, const size_t) {});
+								if (drained == 0 && !client.waitForData(1000))
+									return;
+								got += drained;
+							}
+							bytes += got;
+						}
+					});
+				runner.Report("  shared memory TX", bytes, seconds);
+				runner.Check(bytes == uint64_t(chunks) * ChunkSize && port.GetTxRawDropped() == 0, "shared memory TX lossless");
+
+				std::vector<uint8_t> received(ChunkSize);
+				bytes = 0;
+				seconds = runner.Measure("shared memory RX, 16 KB chunks", chunks, [&]()
+					{
+						for (uint32_t i = 0; i < chunks; i++)
+						{
+							size_t sent = 0;
+							while (sent < ChunkSize)
+							{
+								const size_t written = client.write(chunk.data() + sent, ChunkSize - sent);
+								if (written == 0 && !client.waitForSpace(1000))
+									return;
+								sent += written;
+							}
+							size_t got = 0;
+							while (got < ChunkSize)
+							{
+								const size_t read = port.readBytes(received.data() + got, ChunkSize - got);
+								if (read == 0)
+									return;
+								got += read;
+							}
+							bytes += got;
+						}
+					});
+				runner.Report("  shared memory RX", bytes, seconds);
+				runner.Check(bytes == uint64_t(chunks) * ChunkSize && port.GetRxDropped() == 0, "shared memory RX lossless");
+
+				const uint32_t echoes = runner.Scale(100000);
+				uint32_t answered = 0;
+				runner.Measure("shared memory echo round trip", echoes, [&]()
+					{
+						for (uint32_t i = 0; i < echoes; i++)
+						{
+							const uint8_t value = static_cast<uint8_t>(i);
+							client.write(&value, 1);
+							int echoed;
+							while ((echoed = port.read()) < 0)
+								port.waitForRx(port.GetRxId(), 100);
+							port.write(static_cast<uint8_t>(echoed));
+
+							uint8_t back;
+							while (client.read(&back, 1) == 0)
+								client.waitForData(100);
+							answered += back == value;
+						}
+					});
+				runner.Check(answered == echoes, "shared memory echoes");
+
+				client.Close();
+				server.Close();
+			}
+#endif
+
+			static void Run(BenchmarkRunner& runner)
+			{
+				Link(runner);
+				Capture(runner);
+#if defined(__linux__)
+				Pty(runner);
+				SharedMemory(runner);
+#endif
+			}
+		}
+	}
+}
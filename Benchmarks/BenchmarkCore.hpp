@@ -0,0 +1,294 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ArduinoWindowsHost.h>
+
+#include "Benchmark.hpp"
+
+namespace ArduinoWindowsHost
+{
+	namespace Benchmarks
+	{
+		namespace Core
+		{
+			// Empty sketch, the loop rate is the host's own overhead per pass.
+			class EmptyHost : public LoopHost
+			{
+			protected:
+				void setup() override
+				{
+					Serial.begin();
+				}
+
+				void loop() override
+				{
+				}
+			};
+
+			// Default loop() yields between passes, as an idle sketch would.
+			class IdleHost : public LoopHost
+			{
+			protected:
+				void setup() override
+				{
+					Serial.begin();
+				}
+			};
+
+			template<typename HostType>
+			static void MeasureLoopRate(BenchmarkRunner& runner, const char* name)
+			{
+				HostType host;
+				HostThread thread;
+				thread.Start(host);
+				while (!host.GetHal().Uart0)
+					std::this_thread::yield();
+
+				const uint32_t durationMillis = runner.IsQuick() ? 20 : 500;
+				const uint32_t start = host.GetHal().Iteration.load();
+				const auto startTime = BenchmarkRunner::Now();
+				std::this_thread::sleep_for(std::chrono::milliseconds(durationMillis));
+				const uint32_t iterations = host.GetHal().Iteration.load() - start;
+				const double seconds = BenchmarkRunner::Seconds(startTime);
+				thread.Stop(host);
+
+				runner.Report(name, (iterations / seconds) / 1e6, "M loops/s");
+				runner.Check(iterations > 0, "host loop ran");
+			}
+
+			static void Dispatch(BenchmarkRunner& runner)
+			{
+				IdleHost host;
+				HostThread thread;
+				thread.Start(host);
+				while (!host.GetHal().Uart0)
+					std::this_thread::yield();
+
+				const uint32_t posts = runner.Scale(1000000);
+				uint32_t executed = 0;
+				runner.Measure("Post() to loop thread", posts, [&]()
+					{
+						for (uint32_t i = 0; i < posts; i++)
+							host.Post([&executed]() { executed++; });
+						host.PostAndWait([]() {});
+					});
+				runner.Check(executed == posts, "all posted work ran");
+
+				const uint32_t roundTrips = runner.Scale(20000);
+				uint32_t waited = 0;
+				runner.Measure("PostAndWait() round trip", roundTrips, [&]()
+					{
+						for (uint32_t i = 0; i < roundTrips; i++)
+							host.PostAndWait([&waited]() { waited++; });
+					});
+				runner.Check(waited == roundTrips, "all waited work ran");
+
+				thread.Stop(host);
+			}
+
+			// Sketch that announces itself and blinks, to tell apart hosts sharing the process.
+			template<typename Profile>
+			class BoardHost : public TemplateLoopHost<Profile>
+			{
+			public:
+				uint32_t Id = 0;
+
+			protected:
+				void setup() override
+				{
+					Serial.begin();
+					Serial.println(Id);
+					pinMode(LED_BUILTIN, OUTPUT);
+				}
+
+				void loop() override
+				{
+					digitalWrite(LED_BUILTIN, (millis() & 1) ? HIGH : LOW);
+				}
+			};
+
+			// Independent hosts on one process, each on its own board.
+			template<typename Profile, uint32_t HostCount>
+			static void ParallelHosts(BenchmarkRunner& runner, const char* name)
+			{
+				BoardHost<Profile> hosts[HostCount];
+				HostThread threads[HostCount];
+				for (uint32_t i = 0; i < HostCount; i++)
+				{
+					hosts[i].Id = i + 1;
+					threads[i].Start(hosts[i]);
+				}
+				for (uint32_t i = 0; i < HostCount; i++)
+				{
+					while (!hosts[i].GetHal().Uart0)
+						std::this_thread::yield();
+				}
+
+				const uint32_t durationMillis = runner.IsQuick() ? 20 : 500;
+				const auto startTime = BenchmarkRunner::Now();
+				std::this_thread::sleep_for(std::chrono::milliseconds(durationMillis));
+				uint32_t iterations = 0;
+				bool ran = true;
+				for (uint32_t i = 0; i < HostCount; i++)
+				{
+					const uint32_t hostIterations = hosts[i].GetHal().Iteration.load();
+					ran &= hostIterations > 0;
+					iterations += hostIterations;
+				}
+				const double seconds = BenchmarkRunner::Seconds(startTime);
+
+				bool separate = !Serial;
+				for (uint32_t i = 0; i < HostCount; i++)
+				{
+					threads[i].Stop(hosts[i]);
+					const std::vector<std::string> lines = hosts[i].GetHal().Uart0.getBufferedLines();
+					separate &= lines.size() == 1 && lines[0] == std::to_string(i + 1);
+				}
+
+				runner.Report(name, (iterations / seconds) / 1e6, "M loops/s");
+				runner.Check(ran, "every host loop ran");
+				runner.Check(separate, "hosts keep their own Serial");
+			}
+
+			// Board setup and teardown cost, which tracks its buffer footprint.
+			static void Profiles(BenchmarkRunner& runner)
+			{
+				const uint32_t defaults = runner.Scale(2000);
+				runner.Measure("TemplateHalContext<DefaultBoardProfile>", defaults, [defaults]()
+					{
+						for (uint32_t i = 0; i < defaults; i++)
+							TemplateHalContext<DefaultBoardProfile> context{};
+					});
+
+				const uint32_t compacts = runner.Scale(200000);
+				runner.Measure("TemplateHalContext<CompactBoardProfile>", compacts, [compacts]()
+					{
+						for (uint32_t i = 0; i < compacts; i++)
+							TemplateHalContext<CompactBoardProfile> context{};
+					});
+
+				TemplateHalContext<CompactBoardProfile> compact{};
+				TemplateHalContext<MegaBoardProfile> mega{};
+				runner.Check(compact.GetUartCount() == 1 && &compact.Uart1 == &HalContext::Unconnected()
+					&& compact.Io.GetCount() == CompactBoardProfile::IoCount, "compact board dimensions");
+				runner.Check(mega.GetUartCount() == 4 && mega.Uart3.GetPortId() == 3
+					&& mega.Io.GetCount() == MegaBoardProfile::IoCount, "mega board dimensions");
+			}
+
+			static void Hal(BenchmarkRunner& runner)
+			{
+				const uint32_t count = runner.Scale(20000000);
+
+				pinMode(LED_BUILTIN, OUTPUT);
+				runner.Measure("digitalWrite(), toggling", count, [count]()
+					{
+						for (uint32_t i = 0; i < count; i++)
+							digitalWrite(LED_BUILTIN, (i & 1) ? HIGH : LOW);
+					});
+				runner.Measure("digitalWrite(), level unchanged", count, [count]()
+					{
+						for (uint32_t i = 0; i < count; i++)
+							digitalWrite(LED_BUILTIN, HIGH);
+					});
+
+				uint32_t high = 0;
+				runner.Measure("digitalRead()", count, [count, &high]()
+					{
+						for (uint32_t i = 0; i < count; i++)
+							high += digitalRead(LED_BUILTIN);
+					});
+				DoNotOptimize(high);
+
+				runner.Measure("pinMode()", count, [count]()
+					{
+						for (uint32_t i = 0; i < count; i++)
+							pinMode(static_cast<uint8_t>(i & 7), (i & 8) ? OUTPUT : INPUT);
+					});
+
+				const uint32_t clockCount = runner.Scale(2000000);
+				uint32_t sum = 0;
+				runner.Measure("millis()", clockCount, [clockCount, &sum]()
+					{
+						for (uint32_t i = 0; i < clockCount; i++)
+							sum += millis();
+					});
+				runner.Measure("micros()", clockCount, [clockCount, &sum]()
+					{
+						for (uint32_t i = 0; i < clockCount; i++)
+							sum += micros();
+					});
+				DoNotOptimize(sum);
+			}
+
+			// Snapshots taken while another thread toggles two pins in different words, in turn.
+			// Each toggle bumps its word's counter, so a consistent snapshot has each level matching its counter's parity
+			// and the first counter at most one ahead of the second.
+			static void PinSnapshots(BenchmarkRunner& runner)
+			{
+				static constexpr uint8_t First = 0;
+				static constexpr uint8_t Second = 40;
+
+				ArduinoIo<64> io{};
+				io.pinMode(First, OUTPUT);
+				io.pinMode(Second, OUTPUT);
+				ArduinoPins::Snapshot base{};
+				io.GetSnapshot(base);
+
+				std::atomic<bool> writing{ true };
+				std::thread writer([&]()
+					{
+						for (uint32_t i = 0; writing.load(std::memory_order_relaxed); i++)
+						{
+							io.digitalWrite(First, (i & 1) ? LOW : HIGH);
+							io.digitalWrite(Second, (i & 1) ? LOW : HIGH);
+						}
+					});
+				while (io.GetSequence() == base.Sequence)
+					std::this_thread::yield();
+
+				const uint32_t snapshots = runner.Scale(2000000);
+				uint32_t torn = 0;
+				uint32_t changes = 0;
+				ArduinoPins::Snapshot previous = base;
+				ArduinoPins::Snapshot snapshot{};
+				runner.Measure("GetSnapshot(64 pins), concurrent writer", snapshots, [&]()
+					{
+						for (uint32_t i = 0; i < snapshots; i++)
+						{
+							io.GetSnapshot(snapshot);
+							const uint32_t firstChanges = snapshot.Changes[First / ArduinoPins::PinsPerWord] - base.Changes[First / ArduinoPins::PinsPerWord];
+							const uint32_t secondChanges = snapshot.Changes[Second / ArduinoPins::PinsPerWord] - base.Changes[Second / ArduinoPins::PinsPerWord];
+							torn += snapshot.GetLevel(First) != (firstChanges & 1)
+								|| snapshot.GetLevel(Second) != (secondChanges & 1)
+								|| firstChanges - secondChanges > 1;
+							// Pins may toggle back between snapshots, so count the per-word counters moving.
+							for (uint8_t word = 0; word < snapshot.GetWordCount(); word++)
+								changes += snapshot.Changes[word] != previous.Changes[word];
+							previous = snapshot;
+						}
+					});
+				writing = false;
+				writer.join();
+
+				runner.Check(torn == 0, "snapshots consistent");
+				runner.Check(changes > 0, "snapshot diffs see changes");
+			}
+
+			static void Run(BenchmarkRunner& runner)
+			{
+				MeasureLoopRate<EmptyHost>(runner, "LoopHost, empty loop()");
+				MeasureLoopRate<IdleHost>(runner, "LoopHost, yielding loop()");
+				ParallelHosts<DefaultBoardProfile, 4>(runner, "4 LoopHosts, blinking loop(), total");
+				ParallelHosts<CompactBoardProfile, 32>(runner, "32 compact LoopHosts, blinking loop(), total");
+				Profiles(runner);
+				Dispatch(runner);
+				Hal(runner);
+				PinSnapshots(runner);
+			}
+		}
+	}
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <vector>
+
+#include <ArduinoWindowsHost.h>
+
+#include "Benchmark.hpp"
+
+namespace ArduinoWindowsHost
+{
+	namespace Benchmarks
+	{
+		namespace Framing
+		{
+			// Feeds batches of identical encoded frames and decodes them in place.
+			template<typename Framer, typename Encoding>
+			static void Decode(BenchmarkRunner& runner, const char* name, const size_t length)
+			{
+				ArduinoSerialPort port(0, 16, 1 << 16, 1024, 0);
+				port.begin();
+				Framer framer(port, length);
+
+				std::vector<uint8_t> payload(length);
+				for (size_t i = 0; i < length; i++)
+					payload[i] = static_cast<uint8_t>(i * 7 + 1);
+
+				std::vector<uint8_t> encoded(Encoding::MaxEncodedLength(length));
+				encoded.resize(Encoding::Encode(payload.data(), length, encoded.data()));
+
+				std::vector<uint8_t> batch;
+				while (batch.size() + encoded.size() < 48000)
+					batch.insert(batch.end(), encoded.begin(), encoded.end());
+				const uint32_t perBatch = static_cast<uint32_t>(batch.size() / encoded.size());
+
+				const uint32_t rounds = runner.Scale(static_cast<uint32_t>(4000000 / perBatch));
+				uint64_t frames = 0;
+				uint32_t mismatches = 0;
+				const double seconds = runner.Measure(name, uint64_t(rounds) * perBatch, [&]()
+					{
+						for (uint32_t r = 0; r < rounds; r++)
+						{
+							port.Rx(batch.data(), batch.size());
+							frames += framer.readFrames([&](const SerialFrame& frame)
+								{
+									if (frame.size() != length || frame[length - 1] != payload[length - 1])
+										mismatches++;
+								});
+						}
+					});
+				runner.Report("  payload", frames * length, seconds);
+				runner.Check(frames == uint64_t(rounds) * perBatch && mismatches == 0 && framer.GetFrameErrors() == 0, "frames decoded intact");
+			}
+
+			template<typename Framer>
+			static void Encode(BenchmarkRunner& runner, const char* name, const size_t length)
+			{
+				ArduinoSerialPort port(0, 16, 1024, 1024, 1 << 16);
+				port.SetTxLineLog(false);
+				Framer framer(port, length);
+
+				std::vector<uint8_t> payload(length, 0x55);
+				const uint32_t frames = runner.Scale(4000000);
+				uint32_t written = 0;
+				runner.Measure(name, frames, [&]()
+					{
+						for (uint32_t i = 0; i < frames; i++)
+						{
+							written += framer.writeFrame(payload.data(), length) == length;
+							if ((i & 63) == 63)
+								port.drainTxRaw([](const uint8_t*, const size_t) {});
+						}
+					});
+				runner.Check(written == frames && port.GetTxRawDropped() == 0, "frames written");
+			}
+
+			static void Run(BenchmarkRunner& runner)
+			{
+				Encode<CobsSerialFramer>(runner, "COBS writeFrame(64 bytes)", 64);
+				Encode<SlipSerialFramer>(runner, "SLIP writeFrame(64 bytes)", 64);
+				Decode<CobsSerialFramer, SerialFraming::Cobs>(runner, "COBS readFrames(64 bytes), in place", 64);
+				Decode<SlipSerialFramer, SerialFraming::Slip>(runner, "SLIP readFrames(64 bytes), in place", 64);
+				Decode<CobsSerialFramer, SerialFraming::Cobs>(runner, "COBS readFrames(512 bytes), in place", 512);
+			}
+		}
+	}
+}
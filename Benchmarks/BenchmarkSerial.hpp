@@ -0,0 +1,281 @@
+#pragma once
+
+#include <math.h>
+#include <stdio.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ArduinoWindowsHost.h>
+
+#include "Benchmark.hpp"
+
+namespace ArduinoWindowsHost
+{
+	namespace Benchmarks
+	{
+		namespace SerialPort
+		{
+			static constexpr size_t LineCapacity = 1024;
+			static constexpr size_t RxCapacity = 1 << 16;
+			static constexpr size_t TxCapacity = 1 << 16;
+			static constexpr size_t TxRawCapacity = 1 << 16;
+
+			static void Print(BenchmarkRunner& runner)
+			{
+				const uint32_t count = runner.Scale(2000000);
+
+				ArduinoSerialPort port(0, LineCapacity, RxCapacity, TxCapacity, 0);
+				runner.Measure("println(uint32_t)", count, [&]()
+					{
+						for (uint32_t i = 0; i < count; i++)
+							port.println(i * 7919u);
+					});
+				runner.Measure("println(double, 3)", count, [&]()
+					{
+						for (uint32_t i = 0; i < count; i++)
+							port.println(i * 0.37, 3);
+					});
+				runner.Measure("printf(FMT(\"i=%d v=%u f=%.2f\\n\"))", count, [&]()
+					{
+						for (uint32_t i = 0; i < count; i++)
+							port.printf(FMT("i=%d v=%u f=%.2f\n"), static_cast<int>(i), i * 3u, i * 0.5);
+					});
+				runner.Check(port.getBufferedLines().back() == "i=" + std::to_string(count - 1) + " v=" + std::to_string((count - 1) * 3u)
+					+ " f=" + std::to_string((count - 1) / 2) + ((count - 1) & 1 ? ".50" : ".00"), "printf output");
+
+				// Zero padding: after the sign and %a's 0x, never on inf/nan; same as the C library.
+				ArduinoSerialPort padded(0, LineCapacity, RxCapacity, TxCapacity, 0);
+				padded.printf(FMT("%08a|%08a|%08f|%010a|%+010.2f\n"), HUGE_VAL, NAN, -HUGE_VAL, 1.0, -3.5);
+				char expected[128];
+				snprintf(expected, sizeof(expected), "%08a|%08a|%08f|%010a|%+010.2f", HUGE_VAL, NAN, -HUGE_VAL, 1.0, -3.5);
+				runner.Check(padded.getBufferedLines().back() == expected, "printf float padding");
+
+				// A line assembled from several print() calls, committed per call or once per line.
+				ArduinoSerialPort direct(0, LineCapacity, RxCapacity, TxCapacity, 0);
+				ArduinoSerialPort buffered(0, LineCapacity, RxCapacity, TxCapacity, 0);
+				buffered.SetTxBuffered(true);
+				const uint32_t lines = runner.Scale(1000000);
+				for (ArduinoSerialPort* target : { &direct, &buffered })
+				{
+					runner.Measure(target == &direct ? "print() x5 per line, direct" : "print() x5 per line, buffered", lines, [&]()
+						{
+							for (uint32_t i = 0; i < lines; i++)
+							{
+								target->print("x=");
+								target->print(i);
+								target->print(", y=");
+								target->print(i * 0.5);
+								target->println();
+							}
+							target->flushTxBuffer();
+						});
+				}
+				runner.Check(direct.getBufferedLines().back() == buffered.getBufferedLines().back(), "buffered output matches direct");
+			}
+
+			static void RawTx(BenchmarkRunner& runner)
+			{
+				ArduinoSerialPort port(0, LineCapacity, RxCapacity, TxCapacity, TxRawCapacity);
+				port.SetTxLineLog(false);
+
+				const uint32_t writes = runner.Scale(4000000);
+				uint8_t frame[64];
+				memset(frame, 0xA5, sizeof(frame));
+				uint64_t drained = 0;
+				const double seconds = runner.Measure("write(64 bytes), raw channel drained", writes, [&]()
+					{
+						for (uint32_t i = 0; i < writes; i++)
+						{
+							port.write(frame, sizeof(frame));
+							if ((i & 255) == 255)
+								drained += port.drainTxRaw([](const uint8_t*, const size_t) {});
+						}
+						drained += port.drainTxRaw([](const uint8_t*, const size_t) {});
+					});
+				runner.Report("  raw TX", drained, seconds);
+				runner.Check(drained == uint64_t(writes) * sizeof(frame) && port.GetTxRawDropped() == 0, "raw TX lossless");
+			}
+
+			static void Read(BenchmarkRunner& runner)
+			{
+				ArduinoSerialPort port(0, LineCapacity, RxCapacity, TxCapacity, 0);
+				port.begin();
+				port.setTimeout(0);
+
+				// Batches that fit the RX ring, read back before the next one.
+				std::string batch;
+				uint32_t batchLines = 0;
+				while (batch.size() < RxCapacity / 2)
+				{
+					batch += std::to_string(batchLines * 37) + " " + std::to_string(batchLines) + ".5\n";
+					batchLines++;
+				}
+
+				const uint32_t rounds = runner.Scale(2000);
+				uint64_t sum = 0;
+				double values = 0;
+				runner.Measure("Rx() + parseInt()/parseFloat() per line", uint64_t(rounds) * batchLines, [&]()
+					{
+						for (uint32_t r = 0; r < rounds; r++)
+						{
+							port.Rx(batch.data(), batch.size());
+							while (port.available() > 0)
+							{
+								sum += static_cast<uint64_t>(port.parseInt());
+								values += port.parseFloat();
+								port.read();
+							}
+						}
+					});
+				runner.Check(sum == uint64_t(rounds) * 37 * (uint64_t(batchLines) * (batchLines - 1) / 2), "parsed integers");
+				DoNotOptimize(values);
+
+				uint8_t buffer[4096];
+				uint64_t bytes = 0;
+				const double seconds = runner.Measure("Rx() + readBytes(4 KB)", rounds, [&]()
+					{
+						for (uint32_t r = 0; r < rounds; r++)
+						{
+							port.Rx(batch.data(), batch.size());
+							size_t read;
+							while ((read = port.readBytes(buffer, sizeof(buffer))) > 0)
+								bytes += read;
+						}
+					});
+				runner.Report("  RX", bytes, seconds);
+				runner.Check(bytes == uint64_t(rounds) * batch.size() && port.GetRxDropped() == 0, "RX lossless");
+			}
+
+			// Line-oriented sketch: one serialLineEvent() per command.
+			class LineHost : public LoopHost
+			{
+			public:
+				uint32_t Lines = 0;
+				uint64_t Checksum = 0;
+
+			protected:
+				void setup() override
+				{
+					Serial.begin();
+					SetSerialEventMode(SerialEventMode::LineSpan);
+				}
+
+				void serialLineEvent(const char* line, const size_t length) override
+				{
+					Lines++;
+					Checksum += length;
+				}
+			};
+
+			static void LineEvents(BenchmarkRunner& runner)
+			{
+				LineHost host;
+				HostThread thread;
+				ArduinoSerialPort& serial = host.GetHal().Uart0;
+				serial.SetRxBackpressure(true, 1000);
+				thread.Start(host);
+				while (!serial)
+					std::this_thread::yield();
+
+				const uint32_t lines = runner.Scale(2000000);
+				std::string batch;
+				uint32_t batchLines = 0;
+				uint64_t batchLength = 0;
+				while (batch.size() < 2048)
+				{
+					const std::string command = "cmd " + std::to_string(batchLines);
+					batch += command + "\r\n";
+					batchLength += command.size();
+					batchLines++;
+				}
+
+				const uint32_t rounds = (lines + batchLines - 1) / batchLines;
+				runner.Measure("Rx() -> serialLineEvent() (LineSpan)", uint64_t(rounds) * batchLines, [&]()
+					{
+						for (uint32_t r = 0; r < rounds; r++)
+							serial.Rx(batch.data(), batch.size());
+						while (host.Lines < rounds * batchLines && host.isRunning())
+							host.PostAndWait([]() {});
+					});
+				thread.Stop(host);
+				serial.SetRxBackpressure(false);
+
+				runner.Check(host.Lines == rounds * batchLines && host.Checksum == rounds * batchLength, "one event per line");
+			}
+
+			static void Timing(BenchmarkRunner& runner)
+			{
+				ArduinoSerialPort port(0, LineCapacity, RxCapacity, TxCapacity, TxRawCapacity);
+				port.SetTxLineLog(false);
+
+				// Block: bytes must take their line time, less the FIFO still draining at the end.
+				port.SetTiming(SerialTiming::Block);
+				port.begin(115200);
+				const uint32_t bytes = runner.IsQuick() ? 1216 : 11584;
+				uint8_t chunk[64];
+				memset(chunk, 'x', sizeof(chunk));
+				const auto start = BenchmarkRunner::Now();
+				for (uint32_t i = 0; i < bytes; i += sizeof(chunk))
+				{
+					port.write(chunk, sizeof(chunk));
+					port.drainTxRaw([](const uint8_t*, const size_t) {});
+				}
+				const double blockMillis = BenchmarkRunner::Seconds(start) * 1000;
+				const double expectedMillis = ((bytes - SerialTimingModel::DefaultTxFifo) * 10 * 1000.0) / 115200;
+				runner.Report("write() at 115200 baud, Block", blockMillis, "ms");
+				runner.Report("  expected", expectedMillis, "ms");
+				runner.Check(blockMillis >= expectedMillis * 0.98 && blockMillis <= expectedMillis * 1.25 + 5, "Block paces at the baud rate");
+
+				// Block RX: one long Rx() call shows up a FIFO's worth at a time, not after the whole chunk's line time.
+				{
+					static constexpr uint32_t RxBytes = 1152; // 100 ms at 115200.
+					uint8_t input[RxBytes];
+					memset(input, 'r', sizeof(input));
+					const auto rxStart = BenchmarkRunner::Now();
+					std::thread feeder([&]() { port.Rx(input, sizeof(input)); });
+					while (port.available() == 0)
+						std::this_thread::yield();
+					const double firstMillis = BenchmarkRunner::Seconds(rxStart) * 1000;
+					feeder.join();
+					const double rxMillis = BenchmarkRunner::Seconds(rxStart) * 1000;
+					const int received = port.available();
+					while (port.read() >= 0) {}
+					const double rxExpectedMillis = (RxBytes * 10 * 1000.0) / 115200;
+					runner.Report("Rx(1152 bytes) at 115200 baud, Block, first bytes", firstMillis, "ms");
+					runner.Report("  all bytes", rxMillis, "ms");
+					runner.Check(received == int(RxBytes) && rxMillis >= rxExpectedMillis * 0.98 && firstMillis < rxExpectedMillis / 4, "Block RX trickles in at the baud rate");
+				}
+
+				// Measure: accounted, not waited; the cost is the metering itself.
+				port.SetTiming(SerialTiming::Measure);
+				port.ResetTimingStatistics();
+				const uint32_t writes = runner.Scale(2000000);
+				runner.Measure("write(64 bytes), Measure", writes, [&]()
+					{
+						for (uint32_t i = 0; i < writes; i++)
+						{
+							port.write(chunk, sizeof(chunk));
+							if ((i & 255) == 255)
+								port.drainTxRaw([](const uint8_t*, const size_t) {});
+						}
+					});
+				// The virtual clock accounts every byte's line time, less the FIFO.
+				const SerialTimingModel::Statistics statistics = port.GetTimingStatistics();
+				const double accountedSeconds = statistics.TxBlockedMicros / 1e6;
+				const double lineSeconds = ((uint64_t(writes) * sizeof(chunk) - SerialTimingModel::DefaultTxFifo) * 10.0) / 115200;
+				runner.Report("  accounted blocking", accountedSeconds, "s");
+				runner.Check(accountedSeconds >= lineSeconds * 0.99 && accountedSeconds <= lineSeconds * 1.01, "Measure accounts line time");
+			}
+
+			static void Run(BenchmarkRunner& runner)
+			{
+				Print(runner);
+				RawTx(runner);
+				Read(runner);
+				LineEvents(runner);
+				Timing(runner);
+			}
+		}
+	}
+}
@@ -0,0 +1,70 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "BenchmarkCore.hpp"
+#include "BenchmarkSerial.hpp"
+#include "BenchmarkFraming.hpp"
+#include "BenchmarkBridge.hpp"
+
+using namespace ArduinoWindowsHost::Benchmarks;
+
+static const Suite Suites[] =
+{
+	{ "core", "host loop rate, dispatch queue, HAL calls", Core::Run },
+	{ "serial", "print/printf/buffered TX, raw TX, RX parsing, line events, baud timing", SerialPort::Run },
+	{ "framing", "COBS/SLIP frame encode and in-place decode", Framing::Run },
+	{ "bridge", "serial link, capture log, PTY and shared memory bridges", Bridge::Run },
+};
+
+static int Usage(const char* name)
+{
+	fprintf(stderr, "Usage: %s [--quick] [suite...]\n", name);
+	for (const Suite& suite : Suites)
+		fprintf(stderr, "  %-10s %s\n", suite.Name, suite.Description);
+	return 2;
+}
+
+// Runs the named suites (all by default). --quick scales workloads down for smoke runs.
+// Exit code is the number of failed checks.
+int main(int argc, char** argv)
+{
+	bool quick = false;
+	bool selected[sizeof(Suites) / sizeof(Suites[0])]{};
+	bool any = false;
+	for (int i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "--quick"))
+		{
+			quick = true;
+			continue;
+		}
+
+		bool found = false;
+		for (size_t s = 0; s < sizeof(Suites) / sizeof(Suites[0]); s++)
+		{
+			if (!strcmp(argv[i], Suites[s].Name))
+			{
+				selected[s] = true;
+				found = true;
+			}
+		}
+		if (!found)
+			return Usage(argv[0]);
+		any = true;
+	}
+
+	BenchmarkRunner runner(quick);
+	for (size_t s = 0; s < sizeof(Suites) / sizeof(Suites[0]); s++)
+	{
+		if (any && !selected[s])
+			continue;
+
+		printf("[%s]\n", Suites[s].Name);
+		Suites[s].Run(runner);
+		fflush(stdout);
+	}
+
+	if (runner.GetFailures() > 0)
+		printf("%u check(s) failed.\n", runner.GetFailures());
+	return static_cast<int>(runner.GetFailures());
+}
@@ -9,7 +9,7 @@ using namespace winrt::Windows::UI::Xaml::Media;
 namespace winrt::ArduinoBlink::implementation
 {
 	MainPage::MainPage()
-		: SerialTxAdapter(Serial)
+		: SerialTxAdapter(m_viewModel->HostManager().GetHal().Uart0)
 	{
 		// Ensure XAML holds a ref to the same VM instance
 		DataContext(ViewModel());
@@ -52,7 +52,7 @@ namespace winrt::ArduinoBlink::implementation
 	// Do per-frame work here (UI updates or enqueue work on UI thread).
 	void MainPage::onRendering(winrt::Windows::Foundation::IInspectable const& sender, winrt::Windows::UI::Xaml::Media::RenderingEventArgs const& e)
 	{
-		if (ArduinoWindowsHost::Hal::State::IoHal.State[uint8_t(LED_BUILTIN)].State != 0)
+		if (ViewModel().HostManager().GetHal().Io.GetLevel(LED_BUILTIN) != 0)
 		{
 			if (IoLedBuiltIn().Visibility() != Visibility::Visible)
 				IoLedBuiltIn().Visibility(Visibility::Visible);
@@ -63,7 +63,7 @@ namespace winrt::ArduinoBlink::implementation
 				IoLedBuiltIn().Visibility(Visibility::Collapsed);
 		}
 
-		if (Serial.ElapsedTx() <= SerialLedDuration)
+		if (ViewModel().HostManager().GetHal().Uart0.ElapsedTx() <= SerialLedDuration)
 		{
 			if (IoLedTx().Visibility() != Visibility::Visible)
 				IoLedTx().Visibility(Visibility::Visible);
@@ -74,7 +74,7 @@ namespace winrt::ArduinoBlink::implementation
 				IoLedTx().Visibility(Visibility::Collapsed);
 		}
 
-		if (Serial.ElapsedRx() <= SerialLedDuration)
+		if (ViewModel().HostManager().GetHal().Uart0.ElapsedRx() <= SerialLedDuration)
 		{
 			if (IoLedRx().Visibility() != Visibility::Visible)
 				IoLedRx().Visibility(Visibility::Visible);
@@ -162,7 +162,7 @@ namespace winrt::ArduinoBlink::implementation
 						serialText += '\n';
 				}
 			}
-			Serial.Rx(serialText);
+			ViewModel().HostManager().GetHal().Uart0.Rx(serialText);
 		}
 
 		if (clearInputOnSendCheckBox().IsChecked().GetBoolean())
@@ -173,7 +173,7 @@ namespace winrt::ArduinoBlink::implementation
 	{
 		if (ViewModel().IsRunning())
 		{
-			Serial.flushTx();
+			ViewModel().HostManager().GetHal().Uart0.flushTx();
 		}
 		else
 		{
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <ArduinoWindowsHost.h>
+
+namespace ConsoleRunnerHost
+{
+	using namespace ArduinoWindowsHost;
+
+	/// <summary>
+	/// Headless sketch: blinks the built-in LED with Tick/Tock messages and answers each received line.
+	/// </summary>
+	class ConsoleHost : public LoopHost
+	{
+	private:
+		static constexpr uint32_t BlinkPeriodMillis = 500;
+
+		uint32_t LastBlink = 0;
+		uint32_t Lines = 0;
+		bool TickTock = false;
+
+	public:
+		ConsoleHost() : LoopHost()
+		{
+		}
+
+	protected:
+		void setup() override
+		{
+			Serial.begin(115200);
+			while (!Serial) {}
+
+			SetSerialEventMode(SerialEventMode::LineSpan);
+
+			Serial.println(F("ConsoleRunner Setup"));
+
+			pinMode(LED_BUILTIN, OUTPUT);
+			digitalWrite(LED_BUILTIN, HIGH);
+			LastBlink = millis();
+
+			Serial.println(F("ConsoleRunner Started!"));
+		}
+
+		void serialLineEvent(const char* line, const size_t length) override
+		{
+			Lines++;
+			Serial.print(F("!Line "));
+			Serial.print(Lines);
+			Serial.print(F(": "));
+			Serial.write(line, length);
+			Serial.println();
+		}
+
+		void loop() override
+		{
+			const uint32_t now = millis();
+			if (now - LastBlink >= BlinkPeriodMillis)
+			{
+				LastBlink = now;
+				TickTock = !TickTock;
+				digitalWrite(LED_BUILTIN, TickTock ? LOW : HIGH);
+
+				if (TickTock)
+					Serial.println(F("\tTock"));
+				else
+					Serial.println(F("\tTick"));
+			}
+
+			delay(1);
+		}
+
+		void setdown() override
+		{
+			Serial.print(F("ConsoleRunner Stopped after "));
+			Serial.print(Lines);
+			Serial.println(F(" lines."));
+		}
+	};
+}
@@ -0,0 +1,16 @@
+#include <ArduinoWindowsHost.h>
+#include <Host/ConsoleRunner.hpp>
+
+#include "Host/ConsoleHost.hpp"
+
+int main(int argc, char** argv)
+{
+	using namespace ArduinoWindowsHost;
+
+	ConsoleRunnerConfig config{};
+	if (!TemplateConsoleRunner<ConsoleRunnerHost::ConsoleHost>::ParseArguments(argc, argv, config))
+		return 2;
+
+	TemplateConsoleRunner<ConsoleRunnerHost::ConsoleHost> runner{};
+	return runner.Run(config);
+}
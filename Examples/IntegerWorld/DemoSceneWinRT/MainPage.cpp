@@ -10,7 +10,7 @@ using namespace winrt::Windows::UI::Xaml;
 namespace winrt::DemoSceneWinRT::implementation
 {
 	MainPage::MainPage()
-		: SerialTxAdapter(Serial)
+		: SerialTxAdapter(m_viewModel->HostManager().GetHal().Uart0)
 	{
 #ifndef INTEGER_WORLD_LIGHTS_SHADER_DEBUG
 		// Runtime toggles for ambient/emissive/diffuse/specular are not compiled in —
@@ -334,7 +334,7 @@ namespace winrt::DemoSceneWinRT::implementation
 	{
 		if (ViewModel().IsRunning())
 		{
-			Serial.flushTx();
+			ViewModel().HostManager().GetHal().Uart0.flushTx();
 		}
 		else
 		{
@@ -13,6 +13,19 @@
 // Host addons.
 #include "Host/HostAddonParameter.hpp" 
 
+// In-process serial wiring between ports.
+#include "Bridge/Serial/SerialLink.hpp"
+
+// Serial capture to binary logs and their reader are opt-in, as the reader maps files with the platform APIs
+// (<windows.h> on Windows): include "Bridge/Capture/SerialCapture.hpp" and "Bridge/Capture/SerialCaptureReader.hpp" where used.
+
+// Pseudo-terminal and shared memory bridges for external serial tools, Linux only.
+#if defined(__linux__)
+#include "Bridge/Posix/PtyBridge.hpp"
+#include "Bridge/Posix/SharedSerialServer.hpp"
+#include "Bridge/Posix/SharedSerialClient.hpp"
+#endif
+
 // Only include the scheduler addon if TaskScheduler is available.
 #if defined(__has_include)
 #if __has_include(<TScheduler.hpp>)
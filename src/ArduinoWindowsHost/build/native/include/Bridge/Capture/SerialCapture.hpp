@@ -0,0 +1,372 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "../../HAL/ArduinoSerialPort.hpp"
+#include "SerialCaptureFormat.hpp"
+
+namespace ArduinoWindowsHost
+{
+	/// <summary>
+	/// Streams completed TX lines and RX chunks of one or more ports to a binary capture log
+	/// (see SerialCaptureFormat, read back with SerialCaptureReader).
+	/// - Listener callbacks only copy the record into the active batch under a short lock.
+	/// - A writer thread writes the other batch to disk; batches swap when full or every FlushPeriodMillis.
+	/// - When both batches are busy, records are dropped rather than stalling the sketch,
+	///   and a Gap record marks the loss.
+	/// - A failed write (disk full, I/O error) truncates the log back to its last whole record and stops capturing,
+	///   so the log stays readable; see GetWriteErrors().
+	/// </summary>
+	class SerialCapture : private Hal::ISerialListener
+	{
+	public:
+		static constexpr size_t DefaultBatchSize = 4 * 1024 * 1024;
+		static constexpr uint32_t FlushPeriodMillis = 100;
+		static constexpr uint8_t MaxPorts = 4;
+
+	private:
+		using Format = SerialCaptureFormat;
+
+		struct Batch
+		{
+			std::unique_ptr<uint8_t[]> Data;
+			size_t Length;
+		};
+
+	private:
+		const size_t BatchSize;
+
+		FILE* File = nullptr;
+		std::thread* WriterThread = nullptr;
+
+		// Producers fill Batches[Active]; the writer owns the other one while Writing.
+		std::mutex BatchMutex{};
+		std::condition_variable BatchCv{};
+		Batch Batches[2];
+		uint8_t Active = 0;
+		bool Writing = false;
+		bool Running = false;
+		bool Failed = false;
+		uint64_t PendingGap = 0;
+
+		Hal::ArduinoSerialPort* Ports[MaxPorts]{};
+		uint64_t RxOffset[256]{};
+
+		std::atomic<uint64_t> Records{ 0 };
+		std::atomic<uint64_t> DroppedRecords{ 0 };
+		std::atomic<uint64_t> BytesWritten{ 0 };
+		std::atomic<uint32_t> WriteErrors{ 0 };
+
+	public:
+		SerialCapture(const size_t batchSize = DefaultBatchSize)
+			: ISerialListener()
+			, BatchSize(batchSize)
+		{
+			for (uint8_t i = 0; i < 2; i++)
+			{
+				Batches[i].Data.reset(new uint8_t[batchSize]);
+				Batches[i].Length = 0;
+			}
+		}
+
+		~SerialCapture()
+		{
+			Close();
+		}
+
+		SerialCapture(const SerialCapture&) = delete;
+		SerialCapture& operator=(const SerialCapture&) = delete;
+
+		// Creates (truncates) the log at path and starts the writer.
+		bool Open(const char* path)
+		{
+			if (File != nullptr)
+				return false;
+
+			File = fopen(path, "wb");
+			if (File == nullptr)
+				return false;
+			// Batches are written whole; unbuffered, a failed write leaves nothing behind in stdio to tear the log later.
+			setvbuf(File, nullptr, _IONBF, 0);
+
+			Format::FileHeader header{};
+			header.Magic = Format::Magic;
+			header.Version = Format::Version;
+			header.HeaderSize = sizeof(Format::FileHeader);
+			header.StartClock = Hal::ArduinoSerialPort::GetTxClock();
+			header.StartWallClock = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::system_clock::now().time_since_epoch()).count());
+			if (fwrite(&header, sizeof(header), 1, File) != 1)
+			{
+				fclose(File);
+				File = nullptr;
+				return false;
+			}
+			fflush(File);
+			BytesWritten = sizeof(header);
+
+			{
+				std::lock_guard<std::mutex> lock(BatchMutex);
+				Batches[0].Length = 0;
+				Batches[1].Length = 0;
+				Writing = false;
+				Running = true;
+				Failed = false;
+				PendingGap = 0;
+			}
+			WriteErrors = 0;
+			memset(RxOffset, 0, sizeof(RxOffset));
+			WriterThread = new std::thread(&SerialCapture::Run, this);
+			return true;
+		}
+
+		// Starts capturing port. Returns false when not open or out of port or listener slots.
+		bool Attach(Hal::ArduinoSerialPort& port)
+		{
+			if (File == nullptr)
+				return false;
+
+			for (uint8_t i = 0; i < MaxPorts; i++)
+			{
+				if (Ports[i] == nullptr)
+				{
+					if (!port.addListener(*this))
+						return false;
+					Ports[i] = &port;
+					return true;
+				}
+			}
+			return false;
+		}
+
+		void Detach(Hal::ArduinoSerialPort& port)
+		{
+			for (uint8_t i = 0; i < MaxPorts; i++)
+			{
+				if (Ports[i] == &port)
+				{
+					port.removeListener(*this);
+					Ports[i] = nullptr;
+				}
+			}
+		}
+
+		// Detaches all ports, writes everything captured and closes the log.
+		void Close()
+		{
+			for (uint8_t i = 0; i < MaxPorts; i++)
+			{
+				if (Ports[i] != nullptr)
+					Detach(*Ports[i]);
+			}
+
+			if (WriterThread != nullptr)
+			{
+				{
+					std::lock_guard<std::mutex> lock(BatchMutex);
+					Running = false;
+				}
+				BatchCv.notify_all();
+				if (WriterThread->joinable())
+					WriterThread->join();
+				delete WriterThread;
+				WriterThread = nullptr;
+			}
+
+			if (File != nullptr)
+			{
+				fclose(File);
+				File = nullptr;
+			}
+		}
+
+		bool IsOpen() const
+		{
+			return File != nullptr;
+		}
+
+		// Records accepted for writing.
+		uint64_t GetRecords() const
+		{
+			return Records.load(std::memory_order_relaxed);
+		}
+
+		// Records lost because both batches were busy.
+		uint64_t GetDroppedRecords() const
+		{
+			return DroppedRecords.load(std::memory_order_relaxed);
+		}
+
+		// Log size on disk so far, whole records only.
+		uint64_t GetBytesWritten() const
+		{
+			return BytesWritten.load(std::memory_order_relaxed);
+		}
+
+		// Failed batch writes; capturing stops at the first one.
+		uint32_t GetWriteErrors() const
+		{
+			return WriteErrors.load(std::memory_order_relaxed);
+		}
+
+	private:
+		void OnSerialTxLine(const uint8_t portId, const Hal::SerialTxLineInfo& info, const char* line, const size_t length) final
+		{
+			Append(Format::RecordType::TxLine, portId, info.Timestamp, info.Iteration, info.Sequence, line, length);
+		}
+
+		void OnSerialRx(const uint8_t portId, const uint32_t iteration, const uint8_t* data, const size_t length) final
+		{
+			// Rx() callbacks of a port are serialized, so its offset needs no lock.
+			const uint64_t offset = RxOffset[portId];
+			RxOffset[portId] += length;
+			Append(Format::RecordType::Rx, portId, Hal::ArduinoSerialPort::GetTxClock(), iteration, offset, data, length);
+		}
+
+		void Append(const Format::RecordType type, const uint8_t portId, const uint64_t timestamp, const uint32_t iteration,
+			const uint64_t sequence, const void* data, const size_t length)
+		{
+			const size_t size = Format::RecordSize(length);
+			const size_t gapSize = Format::RecordSize(0);
+
+			std::lock_guard<std::mutex> lock(BatchMutex);
+			if (!Running)
+				return;
+			if (Failed)
+			{
+				DroppedRecords.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+
+			Batch* batch = &Batches[Active];
+			const size_t needed = size + (PendingGap > 0 ? gapSize : 0);
+			if (batch->Length + needed > BatchSize)
+			{
+				if (Writing || batch->Length == 0 || needed > BatchSize)
+				{
+					PendingGap++;
+					DroppedRecords.fetch_add(1, std::memory_order_relaxed);
+					return;
+				}
+
+				SwapLocked();
+				BatchCv.notify_one();
+				batch = &Batches[Active];
+			}
+
+			if (PendingGap > 0)
+			{
+				WriteRecord(*batch, Format::RecordType::Gap, portId, timestamp, iteration, PendingGap, nullptr, 0);
+				PendingGap = 0;
+			}
+			WriteRecord(*batch, type, portId, timestamp, iteration, sequence, data, length);
+			Records.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		static void WriteRecord(Batch& batch, const Format::RecordType type, const uint8_t portId, const uint64_t timestamp,
+			const uint32_t iteration, const uint64_t sequence, const void* data, const size_t length)
+		{
+			Format::RecordHeader header{};
+			header.Length = static_cast<uint32_t>(length);
+			header.Type = static_cast<uint8_t>(type);
+			header.PortId = portId;
+			header.Iteration = iteration;
+			header.Timestamp = timestamp;
+			header.Sequence = sequence;
+
+			uint8_t* target = batch.Data.get() + batch.Length;
+			memcpy(target, &header, sizeof(header));
+			if (length > 0)
+				memcpy(target + sizeof(header), data, length);
+
+			const size_t size = Format::RecordSize(length);
+			memset(target + sizeof(header) + length, 0, size - sizeof(header) - length);
+			batch.Length += size;
+		}
+
+		// Hands the active batch to the writer, assumes BatchMutex is held and the writer is idle.
+		void SwapLocked()
+		{
+			Writing = true;
+			Active ^= 1;
+		}
+
+		void Run()
+		{
+			std::unique_lock<std::mutex> lock(BatchMutex);
+			while (true)
+			{
+				BatchCv.wait_for(lock, std::chrono::milliseconds(static_cast<uint32_t>(FlushPeriodMillis)), [this]() { return Writing || !Running; });
+
+				// Periodic flush of a partial batch, and the final one on close.
+				if (!Writing && Batches[Active].Length > 0)
+					SwapLocked();
+
+				if (Writing)
+				{
+					Batch& batch = Batches[Active ^ 1];
+					lock.unlock();
+					const bool written = Failed || WriteBatch(batch);
+					lock.lock();
+					Writing = false;
+					if (!written)
+					{
+						Failed = true;
+						Batches[Active].Length = 0;
+					}
+				}
+				else if (!Running)
+				{
+					return;
+				}
+			}
+		}
+
+		// Returns false when the batch didn't fully reach the file, after cutting the file back to the last whole record.
+		bool WriteBatch(Batch& batch)
+		{
+			bool written = true;
+			if (batch.Length > 0)
+			{
+				const size_t count = fwrite(batch.Data.get(), 1, batch.Length, File);
+				if (fflush(File) != 0 || count != batch.Length)
+				{
+					written = false;
+					WriteErrors.fetch_add(1, std::memory_order_relaxed);
+					Truncate(BytesWritten.load(std::memory_order_relaxed));
+				}
+				else
+					BytesWritten.fetch_add(count, std::memory_order_relaxed);
+			}
+			batch.Length = 0;
+			return written;
+		}
+
+		// Drops a torn tail, so readers (and a later reopen for reading) stay record aligned.
+		void Truncate(const uint64_t size)
+		{
+			clearerr(File);
+#if defined(_WIN32)
+			_chsize_s(_fileno(File), static_cast<__int64>(size));
+#else
+			if (ftruncate(fileno(File), static_cast<off_t>(size)) != 0)
+				return;
+#endif
+			fseek(File, 0, SEEK_END);
+		}
+	};
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace ArduinoWindowsHost
+{
+	/// <summary>
+	/// On-disk layout of serial capture logs (native byte order).
+	/// A file header, then back to back records: a fixed RecordHeader and its payload, padded to 8 bytes.
+	/// Records are only ever appended, so a log can be mapped and read while it's being written.
+	/// </summary>
+	struct SerialCaptureFormat
+	{
+		static constexpr uint64_t Magic = 0x3150414353574141ULL; // "AAWSCAP1"
+		static constexpr uint32_t Version = 1;
+		static constexpr size_t Alignment = 8;
+
+		enum class RecordType : uint8_t
+		{
+			TxLine = 1,	// A completed TX line, without its line ending. Sequence is the port's line sequence.
+			Rx = 2,		// A chunk accepted into RX. Sequence is the chunk's byte offset in the port's RX stream.
+			Gap = 3		// Records lost to a full writer. Sequence is the number of records lost.
+		};
+
+		struct FileHeader
+		{
+			uint64_t Magic;
+			uint32_t Version;
+			uint32_t HeaderSize;
+			uint64_t StartClock;		// Record clock (ArduinoSerialPort::GetTxClock()) at capture start.
+			uint64_t StartWallClock;	// Unix time at capture start (ns).
+		};
+
+		struct RecordHeader
+		{
+			uint32_t Length;		// Payload bytes, excluding padding.
+			uint8_t Type;			// RecordType.
+			uint8_t PortId;
+			uint16_t Reserved;
+			uint32_t Iteration;		// Loop iteration the record was produced in.
+			uint32_t Reserved2;
+			uint64_t Timestamp;		// Record clock (ns).
+			uint64_t Sequence;
+		};
+
+		static_assert(sizeof(FileHeader) == 32, "Capture file header layout.");
+		static_assert(sizeof(RecordHeader) == 32, "Capture record header layout.");
+
+		// Bytes a record with length payload bytes takes in the log.
+		static constexpr size_t RecordSize(const size_t length)
+		{
+			return sizeof(RecordHeader) + ((length + Alignment - 1) & ~(Alignment - 1));
+		}
+	};
+}
@@ -0,0 +1,418 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "SerialCaptureFormat.hpp"
+
+namespace ArduinoWindowsHost
+{
+	/// <summary>
+	/// Memory maps a serial capture log (see SerialCapture) and reads its records in place.
+	/// - Open() indexes the log with one pass over the record headers, keeping every IndexStride-th record,
+	///   so seeking by time or line number is a binary search plus a short scan, whatever the log size.
+	/// - Refresh() maps and indexes records appended since, for following a log that's still being written.
+	/// - A record cut short at the end (still being written) is left for the next Refresh().
+	/// - A log that shrank (the writer cut back a failed batch) is re-indexed from before the cut on Refresh().
+	///   Records read before that may point past the new end: don't use them after the writer reports an error.
+	/// </summary>
+	class SerialCaptureReader
+	{
+	public:
+		using Format = SerialCaptureFormat;
+
+		// Records between index entries.
+		static constexpr uint32_t IndexStride = 4096;
+
+		struct Record
+		{
+			uint64_t Offset;		// File offset of the record.
+			uint64_t LineNumber;	// TX lines before this record, across all ports.
+			Format::RecordType Type;
+			uint8_t PortId;
+			uint32_t Iteration;
+			uint64_t Timestamp;
+			uint64_t Sequence;
+			const char* Data;		// Payload, valid while the reader stays mapped.
+			size_t Length;
+		};
+
+	private:
+		struct IndexEntry
+		{
+			uint64_t Offset;
+			uint64_t RecordNumber;
+			uint64_t LineNumber;
+			uint64_t PriorMaxTimestamp; // Latest timestamp before this record, keeps the search monotonic.
+		};
+
+	private:
+		const uint8_t* Data = nullptr;
+		uint64_t Size = 0;
+
+#if defined(_WIN32)
+		HANDLE FileHandle = INVALID_HANDLE_VALUE;
+		HANDLE MappingHandle = nullptr;
+#else
+		int FileDescriptor = -1;
+#endif
+
+		std::vector<IndexEntry> Index{};
+
+		// Indexing progress: end of the last complete record and running totals up to it.
+		uint64_t End = 0;
+		uint64_t RecordCount = 0;
+		uint64_t LineCount = 0;
+		uint64_t MaxTimestamp = 0;
+
+	public:
+		SerialCaptureReader() = default;
+
+		~SerialCaptureReader()
+		{
+			Close();
+		}
+
+		SerialCaptureReader(const SerialCaptureReader&) = delete;
+		SerialCaptureReader& operator=(const SerialCaptureReader&) = delete;
+
+		// Maps and indexes the log at path. Returns false if missing or not a capture log.
+		bool Open(const char* path)
+		{
+			Close();
+
+#if defined(_WIN32)
+			FileHandle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (FileHandle == INVALID_HANDLE_VALUE)
+				return false;
+#else
+			FileDescriptor = open(path, O_RDONLY);
+			if (FileDescriptor < 0)
+				return false;
+#endif
+			if (!Map() || Size < sizeof(Format::FileHeader)
+				|| GetHeader().Magic != Format::Magic
+				|| GetHeader().Version != Format::Version
+				|| GetHeader().HeaderSize < sizeof(Format::FileHeader))
+			{
+				Close();
+				return false;
+			}
+
+			End = GetHeader().HeaderSize;
+			BuildIndex();
+			return true;
+		}
+
+		void Close()
+		{
+			Unmap();
+#if defined(_WIN32)
+			if (FileHandle != INVALID_HANDLE_VALUE)
+			{
+				CloseHandle(FileHandle);
+				FileHandle = INVALID_HANDLE_VALUE;
+			}
+#else
+			if (FileDescriptor >= 0)
+			{
+				close(FileDescriptor);
+				FileDescriptor = -1;
+			}
+#endif
+			Index.clear();
+			End = 0;
+			RecordCount = 0;
+			LineCount = 0;
+			MaxTimestamp = 0;
+		}
+
+		// Picks up records appended since Open() or the last Refresh(). Returns true if there are new ones.
+		bool Refresh()
+		{
+			if (Data == nullptr)
+				return false;
+
+			const uint64_t records = RecordCount;
+			Unmap();
+			if (!Map() || Size < sizeof(Format::FileHeader) || Size < Begin())
+			{
+				Close();
+				return false;
+			}
+
+			if (Size < End)
+				Rewind();
+			BuildIndex();
+			return RecordCount != records;
+		}
+
+		bool IsOpen() const
+		{
+			return Data != nullptr;
+		}
+
+		const Format::FileHeader& GetHeader() const
+		{
+			return *reinterpret_cast<const Format::FileHeader*>(Data);
+		}
+
+		// Complete records in the log.
+		uint64_t GetRecordCount() const
+		{
+			return RecordCount;
+		}
+
+		// TX line records in the log.
+		uint64_t GetLineCount() const
+		{
+			return LineCount;
+		}
+
+		// Offset of the first record.
+		uint64_t Begin() const
+		{
+			return GetHeader().HeaderSize;
+		}
+
+		// Offset past the last complete record.
+		uint64_t GetEnd() const
+		{
+			return End;
+		}
+
+		// Converts a record timestamp to Unix time (ns).
+		uint64_t ToWallClock(const uint64_t timestamp) const
+		{
+			return GetHeader().StartWallClock + (timestamp - GetHeader().StartClock);
+		}
+
+		// Reads the record at offset and advances offset past it. Returns false at the end.
+		// LineNumber is only filled in by visit(); use FindLine() to seek by line.
+		bool ReadAt(uint64_t& offset, Record& record) const
+		{
+			if (offset + sizeof(Format::RecordHeader) > End)
+				return false;
+
+			Format::RecordHeader header;
+			memcpy(&header, Data + offset, sizeof(header));
+			if (offset + Format::RecordSize(header.Length) > End)
+				return false;
+
+			record.Offset = offset;
+			record.LineNumber = 0;
+			record.Type = static_cast<Format::RecordType>(header.Type);
+			record.PortId = header.PortId;
+			record.Iteration = header.Iteration;
+			record.Timestamp = header.Timestamp;
+			record.Sequence = header.Sequence;
+			record.Data = reinterpret_cast<const char*>(Data + offset + sizeof(header));
+			record.Length = header.Length;
+
+			offset += Format::RecordSize(header.Length);
+			return true;
+		}
+
+		/// <summary>
+		/// Visits records from offset as visitor(const Record&), until the end or visitor returns false.
+		/// </summary>
+		/// <param name="lineNumber">TX lines before offset, as returned by FindLine()/FindTime().</param>
+		/// <returns>Records visited.</returns>
+		template<typename F>
+		uint64_t visit(uint64_t offset, uint64_t lineNumber, F&& visitor) const
+		{
+			uint64_t count = 0;
+			Record record;
+			while (ReadAt(offset, record))
+			{
+				record.LineNumber = lineNumber;
+				count++;
+				if (!visitor(static_cast<const Record&>(record)))
+					break;
+				if (record.Type == Format::RecordType::TxLine)
+					lineNumber++;
+			}
+			return count;
+		}
+
+		// Offset of the TX line record with the given line number (0 based, across ports), GetEnd() if past the last.
+		uint64_t FindLine(const uint64_t lineNumber) const
+		{
+			if (lineNumber >= LineCount)
+				return End;
+
+			size_t low = 0;
+			size_t high = Index.size();
+			while (high - low > 1)
+			{
+				const size_t middle = (low + high) / 2;
+				if (Index[middle].LineNumber <= lineNumber)
+					low = middle;
+				else
+					high = middle;
+			}
+
+			uint64_t offset = Index[low].Offset;
+			uint64_t line = Index[low].LineNumber;
+			Record record;
+			uint64_t start = offset;
+			while (ReadAt(offset, record))
+			{
+				if (record.Type == Format::RecordType::TxLine)
+				{
+					if (line == lineNumber)
+						return start;
+					line++;
+				}
+				start = offset;
+			}
+			return End;
+		}
+
+		// Offset of the first record at or after timestamp, GetEnd() if none.
+		// lineNumber receives the TX lines before it, for visit().
+		uint64_t FindTime(const uint64_t timestamp, uint64_t& lineNumber) const
+		{
+			lineNumber = LineCount;
+			if (Index.empty())
+				return End;
+
+			size_t low = 0;
+			size_t high = Index.size();
+			while (high - low > 1)
+			{
+				const size_t middle = (low + high) / 2;
+				if (Index[middle].PriorMaxTimestamp < timestamp)
+					low = middle;
+				else
+					high = middle;
+			}
+
+			uint64_t offset = Index[low].Offset;
+			uint64_t line = Index[low].LineNumber;
+			uint64_t latest = Index[low].PriorMaxTimestamp;
+			Record record;
+			uint64_t start = offset;
+			while (ReadAt(offset, record))
+			{
+				if (record.Timestamp > latest)
+					latest = record.Timestamp;
+				if (latest >= timestamp)
+				{
+					lineNumber = line;
+					return start;
+				}
+				if (record.Type == Format::RecordType::TxLine)
+					line++;
+				start = offset;
+			}
+			return End;
+		}
+
+	private:
+		// Moves End back to the last index entry before Size, with the totals up to it.
+		void Rewind()
+		{
+			while (!Index.empty() && Index.back().Offset >= Size)
+				Index.pop_back();
+
+			if (Index.empty())
+			{
+				End = Begin();
+				RecordCount = 0;
+				LineCount = 0;
+				MaxTimestamp = 0;
+				return;
+			}
+
+			// BuildIndex() adds this entry back.
+			const IndexEntry entry = Index.back();
+			Index.pop_back();
+			End = entry.Offset;
+			RecordCount = entry.RecordNumber;
+			LineCount = entry.LineNumber;
+			MaxTimestamp = entry.PriorMaxTimestamp;
+		}
+
+		// Indexes complete records from End onwards.
+		void BuildIndex()
+		{
+			uint64_t offset = End;
+			while (offset + sizeof(Format::RecordHeader) <= Size)
+			{
+				Format::RecordHeader header;
+				memcpy(&header, Data + offset, sizeof(header));
+				const uint64_t next = offset + Format::RecordSize(header.Length);
+				if (next > Size)
+					break;
+
+				if (RecordCount % IndexStride == 0)
+					Index.push_back({ offset, RecordCount, LineCount, MaxTimestamp });
+
+				RecordCount++;
+				if (header.Type == static_cast<uint8_t>(Format::RecordType::TxLine))
+					LineCount++;
+				if (header.Timestamp > MaxTimestamp)
+					MaxTimestamp = header.Timestamp;
+				offset = next;
+			}
+			End = offset;
+		}
+
+		bool Map()
+		{
+#if defined(_WIN32)
+			LARGE_INTEGER size;
+			if (!GetFileSizeEx(FileHandle, &size) || size.QuadPart == 0)
+				return false;
+			MappingHandle = CreateFileMappingA(FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (MappingHandle == nullptr)
+				return false;
+			Data = static_cast<const uint8_t*>(MapViewOfFile(MappingHandle, FILE_MAP_READ, 0, 0, 0));
+			Size = static_cast<uint64_t>(size.QuadPart);
+#else
+			struct stat info;
+			if (fstat(FileDescriptor, &info) != 0 || info.st_size == 0)
+				return false;
+			void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, FileDescriptor, 0);
+			Data = data == MAP_FAILED ? nullptr : static_cast<const uint8_t*>(data);
+			Size = static_cast<uint64_t>(info.st_size);
+			if (Data != nullptr)
+				madvise(const_cast<uint8_t*>(Data), static_cast<size_t>(Size), MADV_SEQUENTIAL);
+#endif
+			return Data != nullptr;
+		}
+
+		void Unmap()
+		{
+#if defined(_WIN32)
+			if (Data != nullptr)
+				UnmapViewOfFile(Data);
+			if (MappingHandle != nullptr)
+			{
+				CloseHandle(MappingHandle);
+				MappingHandle = nullptr;
+			}
+#else
+			if (Data != nullptr)
+				munmap(const_cast<uint8_t*>(Data), static_cast<size_t>(Size));
+#endif
+			Data = nullptr;
+			Size = 0;
+		}
+	};
+}
@@ -0,0 +1,371 @@
+#pragma once
+
+#if defined(__linux__)
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include "../../HAL/ArduinoSerialPort.hpp"
+
+namespace ArduinoWindowsHost
+{
+	/// <summary>
+	/// Exposes an ArduinoSerialPort as a Linux pseudo-terminal, so external serial tools can talk to the sketch.
+	/// - One epoll thread pumps both ways with non-blocking batched I/O: raw TX spans are written to the PTY
+	///   straight from the port's raw channel, PTY input is read in chunks into the RX ring.
+	/// - The sketch's raw TX writes wake the loop through an eventfd, at most once per pending batch.
+	/// - When the RX ring is full the PTY isn't read, so the kernel buffer backs up to the tool as flow control.
+	/// - Reads the port's raw TX channel, enabling it on Open() if needed; the bridge is its single reader.
+	/// </summary>
+	class PtyBridge : private Hal::ISerialListener
+	{
+	private:
+		// PTY read/write chunk.
+		static constexpr size_t ChunkSize = 4096;
+
+		// Poll period while the RX ring is full (ms).
+		static constexpr int RxFullPollMillis = 1;
+
+		static constexpr uint64_t WakeTx = 1;
+		static constexpr uint64_t WakeStop = 1ULL << 32;
+
+	private:
+		Hal::ArduinoSerialPort& Port;
+
+		int MasterFd = -1;
+		int SlavePlaceholderFd = -1;
+		int EpollFd = -1;
+		int WakeFd = -1;
+
+		std::string SlavePath{};
+		std::string LinkPath{};
+
+		std::thread* EventThread = nullptr;
+
+		// Set when a wake-up is in flight, so a burst of writes signals the eventfd once.
+		std::atomic<bool> WakePending{ false };
+
+		// Event thread state.
+		bool TxBlocked = false;
+		bool RxPaused = false;
+
+		std::atomic<uint64_t> BytesToPty{ 0 };
+		std::atomic<uint64_t> BytesFromPty{ 0 };
+		std::atomic<uint32_t> Wakeups{ 0 };
+
+	public:
+		PtyBridge(Hal::ArduinoSerialPort& port)
+			: ISerialListener()
+			, Port(port)
+		{
+		}
+
+		~PtyBridge()
+		{
+			Close();
+		}
+
+		PtyBridge(const PtyBridge&) = delete;
+		PtyBridge& operator=(const PtyBridge&) = delete;
+
+		/// <summary>
+		/// Creates the PTY in raw mode and starts pumping.
+		/// </summary>
+		/// <param name="linkPath">Optional stable symlink to the slave device (e.g. /tmp/ttyArduino).</param>
+		/// <returns>False if the PTY can't be set up.</returns>
+		bool Open(const char* linkPath = nullptr)
+		{
+			if (MasterFd >= 0)
+				return true;
+			Port.EnableTxRaw();
+
+			if (!OpenPty() || !OpenEvents())
+			{
+				CloseFds();
+				return false;
+			}
+
+			if (linkPath != nullptr)
+			{
+				unlink(linkPath);
+				if (symlink(SlavePath.c_str(), linkPath) == 0)
+					LinkPath = linkPath;
+			}
+
+			TxBlocked = false;
+			RxPaused = false;
+			WakePending = false;
+			if (!Port.addListener(*this))
+			{
+				CloseFds();
+				return false;
+			}
+
+			EventThread = new std::thread(&PtyBridge::Run, this);
+
+			// Pick up bytes written before the bridge existed.
+			Wake();
+			return true;
+		}
+
+		// Stops pumping and removes the PTY.
+		void Close()
+		{
+			if (EventThread != nullptr)
+			{
+				const uint64_t stop = WakeStop;
+				if (write(WakeFd, &stop, sizeof(stop)) < 0) {}
+				if (EventThread->joinable())
+					EventThread->join();
+				delete EventThread;
+				EventThread = nullptr;
+
+				Port.removeListener(*this);
+			}
+
+			if (!LinkPath.empty())
+			{
+				unlink(LinkPath.c_str());
+				LinkPath.clear();
+			}
+			CloseFds();
+		}
+
+		bool IsOpen() const
+		{
+			return MasterFd >= 0;
+		}
+
+		// Slave device path for serial tools (e.g. /dev/pts/3), empty when closed.
+		const std::string& GetPath() const
+		{
+			return LinkPath.empty() ? SlavePath : LinkPath;
+		}
+
+		// Bytes written from the port's TX to the PTY.
+		uint64_t GetBytesToPty() const
+		{
+			return BytesToPty.load(std::memory_order_relaxed);
+		}
+
+		// Bytes read from the PTY into the port's RX.
+		uint64_t GetBytesFromPty() const
+		{
+			return BytesFromPty.load(std::memory_order_relaxed);
+		}
+
+		// Event loop wake-ups by TX writes.
+		uint32_t GetWakeups() const
+		{
+			return Wakeups.load(std::memory_order_relaxed);
+		}
+
+	private:
+		void OnSerialTxRaw(const uint8_t portId, const uint8_t* data, const size_t length) final
+		{
+			if (!WakePending.exchange(true, std::memory_order_acq_rel))
+				Wake();
+		}
+
+		void Wake()
+		{
+			const uint64_t tx = WakeTx;
+			if (write(WakeFd, &tx, sizeof(tx)) < 0) {}
+		}
+
+		void Run()
+		{
+			epoll_event events[2];
+			while (true)
+			{
+				const int count = epoll_wait(EpollFd, events, 2, RxPaused ? RxFullPollMillis : -1);
+				if (count < 0 && errno != EINTR)
+					break;
+
+				bool tx = false;
+				for (int i = 0; i < count; i++)
+				{
+					if (events[i].data.fd == WakeFd)
+					{
+						uint64_t value = 0;
+						if (read(WakeFd, &value, sizeof(value)) > 0 && value >= WakeStop)
+							return;
+						Wakeups.fetch_add(1, std::memory_order_relaxed);
+						tx = true;
+					}
+					else
+					{
+						if (events[i].events & EPOLLOUT)
+							tx = true;
+						if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+							PumpRx();
+					}
+				}
+
+				if (RxPaused)
+					PumpRx();
+
+				if (tx)
+				{
+					// Clear before draining, a write landing after the drain wakes the loop again.
+					WakePending.store(false, std::memory_order_release);
+					PumpTx();
+				}
+			}
+		}
+
+		// Writes raw TX spans to the PTY until drained or the PTY is full.
+		void PumpTx()
+		{
+			const uint8_t* data;
+			size_t length;
+			while ((length = Port.peekTxRaw(data)) > 0)
+			{
+				const ssize_t written = write(MasterFd, data, length < ChunkSize ? length : ChunkSize);
+				if (written < 0)
+				{
+					if (errno == EINTR)
+						continue;
+					if (errno == EAGAIN || errno == EWOULDBLOCK)
+						SetTxBlocked(true);
+					return;
+				}
+
+				Port.consumeTxRaw(static_cast<size_t>(written));
+				BytesToPty.fetch_add(static_cast<uint64_t>(written), std::memory_order_relaxed);
+			}
+			SetTxBlocked(false);
+		}
+
+		// Reads PTY input into the RX ring, only as much as fits.
+		void PumpRx()
+		{
+			uint8_t chunk[ChunkSize];
+			const size_t slice = Port.GetRxSlice();
+			while (true)
+			{
+				const size_t space = Port.GetRxFree();
+				if (space == 0)
+				{
+					SetRxPaused(true);
+					return;
+				}
+
+				const ssize_t count = read(MasterFd, chunk, std::min({ space, slice, sizeof(chunk) }));
+				if (count <= 0)
+				{
+					if (count < 0 && errno == EINTR)
+						continue;
+					break;
+				}
+
+				Port.Rx(chunk, static_cast<size_t>(count));
+				BytesFromPty.fetch_add(static_cast<uint64_t>(count), std::memory_order_relaxed);
+
+				// Metered RX waits out each slice's line time: one per pass, so TX keeps flowing meanwhile.
+				if (slice != SIZE_MAX)
+					break;
+			}
+			SetRxPaused(false);
+		}
+
+		void SetTxBlocked(const bool blocked)
+		{
+			if (TxBlocked != blocked)
+			{
+				TxBlocked = blocked;
+				UpdateMasterEvents();
+			}
+		}
+
+		void SetRxPaused(const bool paused)
+		{
+			if (RxPaused != paused)
+			{
+				RxPaused = paused;
+				UpdateMasterEvents();
+			}
+		}
+
+		void UpdateMasterEvents()
+		{
+			epoll_event event{};
+			event.events = (RxPaused ? 0u : static_cast<uint32_t>(EPOLLIN)) | (TxBlocked ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+			event.data.fd = MasterFd;
+			epoll_ctl(EpollFd, EPOLL_CTL_MOD, MasterFd, &event);
+		}
+
+		bool OpenPty()
+		{
+			MasterFd = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+			if (MasterFd < 0 || grantpt(MasterFd) != 0 || unlockpt(MasterFd) != 0)
+				return false;
+
+			char path[128];
+			if (ptsname_r(MasterFd, path, sizeof(path)) != 0)
+				return false;
+			SlavePath = path;
+
+			// Holding the slave open keeps the master from reporting hang-ups while no tool is attached,
+			// and lets the raw mode set here persist across tool sessions.
+			SlavePlaceholderFd = open(path, O_RDWR | O_NOCTTY);
+			if (SlavePlaceholderFd < 0)
+				return false;
+
+			termios tio{};
+			if (tcgetattr(SlavePlaceholderFd, &tio) != 0)
+				return false;
+			cfmakeraw(&tio);
+			return tcsetattr(SlavePlaceholderFd, TCSANOW, &tio) == 0;
+		}
+
+		bool OpenEvents()
+		{
+			EpollFd = epoll_create1(EPOLL_CLOEXEC);
+			WakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+			if (EpollFd < 0 || WakeFd < 0)
+				return false;
+
+			epoll_event event{};
+			event.events = EPOLLIN;
+			event.data.fd = WakeFd;
+			if (epoll_ctl(EpollFd, EPOLL_CTL_ADD, WakeFd, &event) != 0)
+				return false;
+
+			event.events = EPOLLIN;
+			event.data.fd = MasterFd;
+			return epoll_ctl(EpollFd, EPOLL_CTL_ADD, MasterFd, &event) == 0;
+		}
+
+		void CloseFds()
+		{
+			CloseFd(WakeFd);
+			CloseFd(EpollFd);
+			CloseFd(SlavePlaceholderFd);
+			CloseFd(MasterFd);
+			SlavePath.clear();
+		}
+
+		static void CloseFd(int& fd)
+		{
+			if (fd >= 0)
+			{
+				close(fd);
+				fd = -1;
+			}
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,355 @@
+#pragma once
+
+#if defined(__linux__)
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <atomic>
+#include <string>
+
+namespace ArduinoWindowsHost
+{
+	static_assert(ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2, "Shared serial channel needs lock-free atomics.");
+
+	/// <summary>
+	/// Cross-process wake-up: a sequence number bumped on every change, with a shared futex to sleep on it.
+	/// Notify() only makes a syscall while someone is waiting.
+	/// </summary>
+	struct SharedSerialSignal
+	{
+		std::atomic<uint32_t> Sequence;
+		std::atomic<uint32_t> Waiters;
+
+		uint32_t Load() const
+		{
+			return Sequence.load();
+		}
+
+		void Notify()
+		{
+			Sequence.fetch_add(1);
+			if (Waiters.load() > 0)
+				syscall(SYS_futex, reinterpret_cast<uint32_t*>(&Sequence), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+		}
+
+		// Sleeps until the sequence differs from seen (see Load()) or the timeout expires.
+		// Returns true if it changed.
+		bool Wait(const uint32_t seen, const uint32_t timeoutMillis)
+		{
+			// Register before the final check, Notify() bumps the sequence before reading Waiters.
+			Waiters.fetch_add(1);
+			if (Sequence.load() == seen)
+			{
+				timespec timeout;
+				timeout.tv_sec = timeoutMillis / 1000;
+				timeout.tv_nsec = static_cast<long>(timeoutMillis % 1000) * 1000000L;
+				syscall(SYS_futex, reinterpret_cast<uint32_t*>(&Sequence), FUTEX_WAIT, seen, &timeout, nullptr, 0);
+			}
+			Waiters.fetch_sub(1);
+
+			return Sequence.load() != seen;
+		}
+	};
+
+	// Positions of one ring in the shared segment. Head and Tail count bytes since creation.
+	struct SharedSerialRingControl
+	{
+		alignas(64) std::atomic<uint64_t> Head;	// Written by the producer.
+		alignas(64) std::atomic<uint64_t> Tail;	// Written by the consumer.
+		uint64_t Capacity;						// Power of two.
+		uint64_t Offset;						// Data offset from the segment start.
+	};
+
+	/// <summary>
+	/// Shared segment header, followed by the TX and RX ring data.
+	/// TX carries sketch output to the client, RX carries client input to the sketch.
+	/// HostSignal wakes the serving host (TX written, TX consumed, RX written); ClientSignal wakes clients
+	/// (TX data ready, RX space freed).
+	/// </summary>
+	struct SharedSerialLayout
+	{
+		static constexpr uint32_t MagicValue = 0x53575741; // "AWWS"
+		static constexpr uint32_t VersionValue = 1;
+
+		uint32_t Magic;
+		uint32_t Version;
+		uint64_t Size;
+		uint32_t PortId;
+		std::atomic<uint32_t> Ready;
+
+		alignas(64) SharedSerialSignal HostSignal;
+		alignas(64) SharedSerialSignal ClientSignal;
+
+		SharedSerialRingControl Tx;
+		SharedSerialRingControl Rx;
+	};
+
+	/// <summary>
+	/// Lock-free single producer, single consumer view of a ring in the shared segment.
+	/// Each side only stores its own position, so producer and consumer may live in different processes.
+	/// </summary>
+	class SharedSerialRing
+	{
+	private:
+		SharedSerialRingControl* Control = nullptr;
+		uint8_t* Data = nullptr;
+		size_t Mask = 0;
+
+	public:
+		SharedSerialRing() = default;
+
+		SharedSerialRing(SharedSerialRingControl& control, uint8_t* segment)
+			: Control(&control)
+			, Data(segment + control.Offset)
+			, Mask(static_cast<size_t>(control.Capacity) - 1)
+		{
+		}
+
+		size_t capacity() const
+		{
+			return Mask + 1;
+		}
+
+		// Consumer: bytes ready to read.
+		size_t available() const
+		{
+			return static_cast<size_t>(Control->Head.load(std::memory_order_acquire) - Control->Tail.load(std::memory_order_relaxed));
+		}
+
+		// Producer: bytes that can be written.
+		size_t space() const
+		{
+			return capacity() - static_cast<size_t>(Control->Head.load(std::memory_order_relaxed) - Control->Tail.load(std::memory_order_acquire));
+		}
+
+		// Producer: copies as much as fits, returns bytes written.
+		size_t write(const uint8_t* data, const size_t length)
+		{
+			const uint64_t head = Control->Head.load(std::memory_order_relaxed);
+			const size_t free = capacity() - static_cast<size_t>(head - Control->Tail.load(std::memory_order_acquire));
+			const size_t count = length < free ? length : free;
+			if (count == 0)
+				return 0;
+
+			const size_t index = static_cast<size_t>(head) & Mask;
+			const size_t first = count < capacity() - index ? count : capacity() - index;
+			memcpy(Data + index, data, first);
+			memcpy(Data, data + first, count - first);
+
+			Control->Head.store(head + count, std::memory_order_release);
+			return count;
+		}
+
+		// Consumer: zero-copy access to the next contiguous span, returns its length (0 if empty).
+		size_t peekSpan(const uint8_t*& data) const
+		{
+			const uint64_t tail = Control->Tail.load(std::memory_order_relaxed);
+			const size_t count = static_cast<size_t>(Control->Head.load(std::memory_order_acquire) - tail);
+			const size_t index = static_cast<size_t>(tail) & Mask;
+			data = Data + index;
+			return count < capacity() - index ? count : capacity() - index;
+		}
+
+		// Consumer: releases count bytes after peekSpan().
+		void consume(const size_t count)
+		{
+			Control->Tail.fetch_add(count, std::memory_order_release);
+		}
+	};
+
+	/// <summary>
+	/// Maps a shared serial segment: created by the serving host, opened by clients.
+	/// The creator holds an exclusive flock() on the segment while it's open. The kernel drops it when
+	/// the process dies, so an unlocked segment is a stale one and a locked one belongs to a live host.
+	/// </summary>
+	class SharedSerialMapping
+	{
+	private:
+		SharedSerialLayout* Layout = nullptr;
+		size_t Size = 0;
+		std::string Name{};
+		bool Owner = false;
+
+		// Holds the owner lock while created here, -1 otherwise.
+		int OwnerFd = -1;
+
+	public:
+		SharedSerialMapping() = default;
+
+		~SharedSerialMapping()
+		{
+			Close();
+		}
+
+		SharedSerialMapping(const SharedSerialMapping&) = delete;
+		SharedSerialMapping& operator=(const SharedSerialMapping&) = delete;
+
+		// Creates with capacities rounded up to powers of two, replacing a stale segment left by a dead host.
+		// Fails if a live host serves the name.
+		bool Create(const char* name, const uint8_t portId, const size_t txCapacity, const size_t rxCapacity)
+		{
+			Close();
+
+			const size_t tx = RoundUp(txCapacity);
+			const size_t rx = RoundUp(rxCapacity);
+			const size_t header = (sizeof(SharedSerialLayout) + 63) & ~static_cast<size_t>(63);
+			const size_t size = header + tx + rx;
+
+			int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+			if (fd < 0 && errno == EEXIST && RemoveStale(name))
+				fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+			if (fd < 0)
+				return false;
+
+			// Another host may have found the new segment unlocked and taken the name, it's theirs then.
+			if (flock(fd, LOCK_EX | LOCK_NB) != 0)
+			{
+				close(fd);
+				return false;
+			}
+
+			void* segment = MAP_FAILED;
+			if (ftruncate(fd, static_cast<off_t>(size)) == 0)
+				segment = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+			if (segment == MAP_FAILED)
+			{
+				shm_unlink(name);
+				close(fd);
+				return false;
+			}
+
+			// A fresh segment is zero filled, which is a valid initial state for the atomics.
+			Layout = static_cast<SharedSerialLayout*>(segment);
+			Layout->Magic = SharedSerialLayout::MagicValue;
+			Layout->Version = SharedSerialLayout::VersionValue;
+			Layout->Size = size;
+			Layout->PortId = portId;
+			Layout->Tx.Capacity = tx;
+			Layout->Tx.Offset = header;
+			Layout->Rx.Capacity = rx;
+			Layout->Rx.Offset = header + tx;
+			Layout->Ready.store(1, std::memory_order_release);
+
+			Size = size;
+			Name = name;
+			Owner = true;
+			OwnerFd = fd;
+			return true;
+		}
+
+		// Opens a segment created by a host, false if missing or not a matching version.
+		bool Open(const char* name)
+		{
+			Close();
+
+			const int fd = shm_open(name, O_RDWR, 0);
+			if (fd < 0)
+				return false;
+
+			struct stat info;
+			void* segment = MAP_FAILED;
+			if (fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= sizeof(SharedSerialLayout))
+				segment = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+			close(fd);
+			if (segment == MAP_FAILED)
+				return false;
+
+			Layout = static_cast<SharedSerialLayout*>(segment);
+			Size = static_cast<size_t>(info.st_size);
+			if (Layout->Ready.load(std::memory_order_acquire) == 0
+				|| Layout->Magic != SharedSerialLayout::MagicValue
+				|| Layout->Version != SharedSerialLayout::VersionValue
+				|| Layout->Size != Size)
+			{
+				Close();
+				return false;
+			}
+
+			Name = name;
+			Owner = false;
+			return true;
+		}
+
+		// Unmaps, and removes the segment name when created here.
+		void Close()
+		{
+			if (Layout != nullptr)
+			{
+				munmap(Layout, Size);
+				Layout = nullptr;
+				Size = 0;
+			}
+			if (Owner)
+			{
+				// Unlinked before the lock goes, so no one can take over the name in between.
+				shm_unlink(Name.c_str());
+				close(OwnerFd);
+				OwnerFd = -1;
+				Owner = false;
+			}
+			Name.clear();
+		}
+
+		bool IsOpen() const
+		{
+			return Layout != nullptr;
+		}
+
+		const std::string& GetName() const
+		{
+			return Name;
+		}
+
+		SharedSerialLayout& GetLayout()
+		{
+			return *Layout;
+		}
+
+		SharedSerialRing GetTx()
+		{
+			return SharedSerialRing(Layout->Tx, reinterpret_cast<uint8_t*>(Layout));
+		}
+
+		SharedSerialRing GetRx()
+		{
+			return SharedSerialRing(Layout->Rx, reinterpret_cast<uint8_t*>(Layout));
+		}
+
+	private:
+		// Unlinks name if no live host holds its owner lock. Returns true if the name is free.
+		static bool RemoveStale(const char* name)
+		{
+			const int fd = shm_open(name, O_RDWR, 0);
+			if (fd < 0)
+				return errno == ENOENT;
+
+			// Holding the lock while unlinking keeps a concurrent Create() from doing the same.
+			const bool stale = flock(fd, LOCK_EX | LOCK_NB) == 0;
+			if (stale)
+				shm_unlink(name);
+			close(fd);
+			return stale;
+		}
+
+		static size_t RoundUp(const size_t capacity)
+		{
+			size_t value = 64;
+			while (value < capacity)
+				value <<= 1;
+			return value;
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,164 @@
+#pragma once
+
+#if defined(__linux__)
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+#include "SharedSerialChannel.hpp"
+
+namespace ArduinoWindowsHost
+{
+	/// <summary>
+	/// Client side of a shared serial channel, for external tools and test harnesses.
+	/// Only depends on SharedSerialChannel.hpp, so it builds without the Arduino HAL.
+	/// - Sketch output is read in place from the shared ring; reading makes no syscalls.
+	/// - Waiting sleeps on a shared futex, woken once per batch the host publishes.
+	/// - One reader and one writer thread at most, as the rings are single producer/consumer.
+	/// </summary>
+	class SharedSerialClient
+	{
+	private:
+		SharedSerialMapping Mapping{};
+		SharedSerialRing Tx{};
+		SharedSerialRing Rx{};
+
+	public:
+		// Attaches to the channel served as name (see SharedSerialServer::Open()).
+		bool Open(const char* name)
+		{
+			if (!Mapping.Open(name))
+				return false;
+
+			Tx = Mapping.GetTx();
+			Rx = Mapping.GetRx();
+			return true;
+		}
+
+		void Close()
+		{
+			Mapping.Close();
+		}
+
+		bool IsOpen() const
+		{
+			return Mapping.IsOpen();
+		}
+
+		uint8_t GetPortId()
+		{
+			return static_cast<uint8_t>(Mapping.GetLayout().PortId);
+		}
+
+	public:
+		// --- Sketch output ---
+
+		// Bytes ready to read.
+		size_t available() const
+		{
+			return Tx.available();
+		}
+
+		// Zero-copy access to the next contiguous span, returns its length (0 if none).
+		// The span stays valid until consume().
+		size_t peek(const uint8_t*& data) const
+		{
+			return Tx.peekSpan(data);
+		}
+
+		// Releases count bytes after peek().
+		void consume(const size_t count)
+		{
+			Tx.consume(count);
+			Mapping.GetLayout().HostSignal.Notify();
+		}
+
+		/// <summary>
+		/// Visits readable bytes in place as visitor(const uint8_t* data, size_t length), consuming them.
+		/// </summary>
+		/// <returns>Bytes visited.</returns>
+		template<typename F>
+		size_t drain(F&& visitor, const size_t maxBytes = SIZE_MAX)
+		{
+			size_t total = 0;
+			const uint8_t* data;
+			size_t length;
+			while (total < maxBytes && (length = Tx.peekSpan(data)) > 0)
+			{
+				if (length > maxBytes - total)
+					length = maxBytes - total;
+				visitor(data, length);
+				Tx.consume(length);
+				total += length;
+			}
+			if (total > 0)
+				Mapping.GetLayout().HostSignal.Notify();
+			return total;
+		}
+
+		// Copying read, returns bytes read.
+		size_t read(uint8_t* buffer, const size_t length)
+		{
+			return drain([&buffer](const uint8_t* data, const size_t count)
+				{
+					memcpy(buffer, data, count);
+					buffer += count;
+				}, length);
+		}
+
+		// Blocks until output is available or the timeout expires. Returns true if available.
+		bool waitForData(const uint32_t timeoutMillis)
+		{
+			return WaitFor(timeoutMillis, [this]() { return Tx.available() > 0; });
+		}
+
+	public:
+		// --- Sketch input ---
+
+		// Free input space.
+		size_t availableForWrite() const
+		{
+			return Rx.space();
+		}
+
+		// Non-blocking write to the sketch's RX, returns bytes accepted.
+		size_t write(const uint8_t* data, const size_t length)
+		{
+			const size_t accepted = Rx.write(data, length);
+			if (accepted > 0)
+				Mapping.GetLayout().HostSignal.Notify();
+			return accepted;
+		}
+
+		size_t write(const char* data, const size_t length)
+		{
+			return write(reinterpret_cast<const uint8_t*>(data), length);
+		}
+
+		size_t write(const std::string& value)
+		{
+			return write(value.data(), value.size());
+		}
+
+		// Blocks until input space is free or the timeout expires. Returns true if free.
+		bool waitForSpace(const uint32_t timeoutMillis)
+		{
+			return WaitFor(timeoutMillis, [this]() { return Rx.space() > 0; });
+		}
+
+	private:
+		template<typename F>
+		bool WaitFor(const uint32_t timeoutMillis, F&& ready)
+		{
+			SharedSerialSignal& signal = Mapping.GetLayout().ClientSignal;
+			const uint32_t seen = signal.Load();
+			if (ready())
+				return true;
+			signal.Wait(seen, timeoutMillis);
+			return ready();
+		}
+	};
+}
+
+#endif
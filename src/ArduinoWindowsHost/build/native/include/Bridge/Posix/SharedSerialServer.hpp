@@ -0,0 +1,211 @@
+#pragma once
+
+#if defined(__linux__)
+
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include "../../HAL/ArduinoSerialPort.hpp"
+#include "SharedSerialChannel.hpp"
+
+namespace ArduinoWindowsHost
+{
+	/// <summary>
+	/// Serves an ArduinoSerialPort over a POSIX shared memory channel, for SharedSerialClient in other processes.
+	/// - A pump thread moves raw TX spans into the shared TX ring and shared RX ring spans into the port's RX.
+	/// - Sketch writes and client activity wake it through a shared futex, with no syscall while it's busy.
+	/// - Output the client hasn't made room for waits in the port's raw TX channel, which drops once full.
+	/// - Reads the port's raw TX channel, enabling it on Open() if needed; the server is its single reader.
+	/// </summary>
+	class SharedSerialServer : private Hal::ISerialListener
+	{
+	public:
+		static constexpr size_t DefaultTxCapacity = 1024 * 1024;
+		static constexpr size_t DefaultRxCapacity = 64 * 1024;
+
+	private:
+		// Longest wait while idle, and while the port's RX is full (ms).
+		static constexpr uint32_t IdleWaitMillis = 100;
+		static constexpr uint32_t RxFullWaitMillis = 1;
+
+	private:
+		Hal::ArduinoSerialPort& Port;
+		SharedSerialMapping Mapping{};
+		SharedSerialRing Tx{};
+		SharedSerialRing Rx{};
+
+		std::thread* PumpThread = nullptr;
+		std::atomic<bool> Running{ false };
+
+		std::atomic<uint64_t> BytesToClient{ 0 };
+		std::atomic<uint64_t> BytesFromClient{ 0 };
+
+	public:
+		SharedSerialServer(Hal::ArduinoSerialPort& port)
+			: ISerialListener()
+			, Port(port)
+		{
+		}
+
+		~SharedSerialServer()
+		{
+			Close();
+		}
+
+		SharedSerialServer(const SharedSerialServer&) = delete;
+		SharedSerialServer& operator=(const SharedSerialServer&) = delete;
+
+		/// <summary>
+		/// Creates the shared segment and starts serving.
+		/// </summary>
+		/// <param name="name">POSIX shared memory name, e.g. "/arduino-serial0".</param>
+		/// <returns>False if the segment can't be created.</returns>
+		bool Open(const char* name, const size_t txCapacity = DefaultTxCapacity, const size_t rxCapacity = DefaultRxCapacity)
+		{
+			if (PumpThread != nullptr)
+				return true;
+			Port.EnableTxRaw();
+
+			if (!Mapping.Create(name, Port.GetPortId(), txCapacity, rxCapacity))
+				return false;
+			Tx = Mapping.GetTx();
+			Rx = Mapping.GetRx();
+
+			if (!Port.addListener(*this))
+			{
+				Mapping.Close();
+				return false;
+			}
+
+			Running = true;
+			PumpThread = new std::thread(&SharedSerialServer::Run, this);
+			return true;
+		}
+
+		// Stops serving and removes the segment name; attached clients keep their mapping.
+		void Close()
+		{
+			if (PumpThread != nullptr)
+			{
+				Running = false;
+				Mapping.GetLayout().HostSignal.Notify();
+				if (PumpThread->joinable())
+					PumpThread->join();
+				delete PumpThread;
+				PumpThread = nullptr;
+
+				Port.removeListener(*this);
+			}
+			Mapping.Close();
+		}
+
+		bool IsOpen() const
+		{
+			return Mapping.IsOpen();
+		}
+
+		const std::string& GetName() const
+		{
+			return Mapping.GetName();
+		}
+
+		// Bytes moved from the port's TX to the client.
+		uint64_t GetBytesToClient() const
+		{
+			return BytesToClient.load(std::memory_order_relaxed);
+		}
+
+		// Bytes moved from the client to the port's RX.
+		uint64_t GetBytesFromClient() const
+		{
+			return BytesFromClient.load(std::memory_order_relaxed);
+		}
+
+	private:
+		void OnSerialTxRaw(const uint8_t portId, const uint8_t* data, const size_t length) final
+		{
+			Mapping.GetLayout().HostSignal.Notify();
+		}
+
+		void Run()
+		{
+			SharedSerialSignal& signal = Mapping.GetLayout().HostSignal;
+			while (Running)
+			{
+				const uint32_t seen = signal.Load();
+
+				bool rxFull = false;
+				const bool moved = PumpTx() | PumpRx(rxFull);
+
+				if (!moved)
+					signal.Wait(seen, rxFull ? RxFullWaitMillis : IdleWaitMillis);
+			}
+		}
+
+		// Copies raw TX spans into the shared TX ring, as far as it has room.
+		bool PumpTx()
+		{
+			size_t total = 0;
+			const uint8_t* data;
+			size_t length;
+			while ((length = Port.peekTxRaw(data)) > 0)
+			{
+				const size_t count = Tx.write(data, length);
+				Port.consumeTxRaw(count);
+				total += count;
+				if (count < length)
+					break;
+			}
+
+			if (total > 0)
+			{
+				BytesToClient.fetch_add(total, std::memory_order_relaxed);
+				Mapping.GetLayout().ClientSignal.Notify();
+			}
+			return total > 0;
+		}
+
+		// Feeds shared RX ring spans to the port, as far as its RX ring has room.
+		bool PumpRx(bool& rxFull)
+		{
+			size_t total = 0;
+			const uint8_t* data;
+			size_t length;
+			const size_t slice = Port.GetRxSlice();
+			while ((length = Rx.peekSpan(data)) > 0)
+			{
+				const size_t space = Port.GetRxFree();
+				if (space == 0)
+				{
+					rxFull = true;
+					break;
+				}
+
+				const size_t count = Port.Rx(data, std::min({ length, space, slice }));
+				Rx.consume(count);
+				total += count;
+				if (count == 0)
+				{
+					rxFull = true;
+					break;
+				}
+
+				// Metered RX waits out each slice's line time: one per pass, so TX keeps flowing meanwhile.
+				if (slice != SIZE_MAX)
+					break;
+			}
+
+			if (total > 0)
+			{
+				BytesFromClient.fetch_add(total, std::memory_order_relaxed);
+				Mapping.GetLayout().ClientSignal.Notify();
+			}
+			return total > 0;
+		}
+	};
+}
+
+#endif
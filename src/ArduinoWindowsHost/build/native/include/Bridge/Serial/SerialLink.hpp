@@ -0,0 +1,285 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <thread>
+#include <algorithm>
+
+#include "../../HAL/ArduinoSerialPort.hpp"
+
+namespace ArduinoWindowsHost
+{
+	// Wire model for a SerialLink. Defaults to an ideal wire: unlimited rate, no latency, bytes dropped when RX is full.
+	struct SerialLinkConfig
+	{
+		// Line rate in bits per second, 0 for unlimited.
+		uint32_t BaudRate = 0;
+
+		// Bits on the wire per byte, 10 for 8N1.
+		uint8_t FrameBits = 10;
+
+		// Extra delay from the end of a byte on the wire to its arrival in RX (µs).
+		uint32_t LatencyMicros = 0;
+
+		// Hardware flow control: bytes the destination can't accept wait in the source raw channel,
+		// instead of being dropped as on a bare UART.
+		bool FlowControl = false;
+	};
+
+	/// <summary>
+	/// One-way serial wire: pumps a port's raw TX channel into another port's RX ring on its own thread.
+	/// - Source and destination may be the same port (loopback) or belong to different hosts.
+	/// - Bytes move straight from the source raw TX span into the destination RX ring, no staging copy.
+	///   With a baud rate or latency, bytes wait in the source raw channel until their arrival time.
+	/// - The link is the raw channel's single reader; the source must have one (txRawCapacity > 0).
+	/// </summary>
+	class SerialLink
+	{
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		// Longest idle wait for source TX, bounds Stop() latency.
+		static constexpr uint32_t IdleWaitMillis = 10;
+
+		// Bytes seen in the source raw channel, and when the first of them started on the wire.
+		struct Segment
+		{
+			size_t Count;
+			int64_t Start;
+		};
+
+	private:
+		Hal::ArduinoSerialPort& Source;
+		Hal::ArduinoSerialPort& Destination;
+		const SerialLinkConfig Config;
+
+		// Wire time of one byte and delivery latency (ns).
+		const int64_t ByteNanos;
+		const int64_t LatencyNanos;
+
+		std::thread* PumpThread = nullptr;
+		std::atomic<bool> Running{ false };
+
+		// Pump thread state.
+		std::deque<Segment> Pending{};
+		size_t Scheduled = 0;
+		int64_t WireFree = 0;
+
+		std::atomic<uint64_t> BytesTransferred{ 0 };
+		std::atomic<uint64_t> BytesDropped{ 0 };
+
+	public:
+		SerialLink(Hal::ArduinoSerialPort& source, Hal::ArduinoSerialPort& destination, const SerialLinkConfig& config = SerialLinkConfig())
+			: Source(source)
+			, Destination(destination)
+			, Config(config)
+			, ByteNanos(config.BaudRate > 0 ? (static_cast<int64_t>(config.FrameBits) * 1000000000LL) / config.BaudRate : 0)
+			, LatencyNanos(static_cast<int64_t>(config.LatencyMicros) * 1000)
+		{
+		}
+
+		~SerialLink()
+		{
+			Stop();
+		}
+
+		SerialLink(const SerialLink&) = delete;
+		SerialLink& operator=(const SerialLink&) = delete;
+
+		// Starts pumping, enabling the source's raw TX channel if it has none.
+		bool Start()
+		{
+			if (PumpThread != nullptr)
+				return true;
+			Source.EnableTxRaw();
+
+			Pending.clear();
+			Scheduled = 0;
+			WireFree = 0;
+			Running = true;
+			PumpThread = new std::thread(&SerialLink::Pump, this);
+			return true;
+		}
+
+		// Stops pumping. Bytes still on the wire stay in the source raw channel.
+		void Stop()
+		{
+			if (PumpThread == nullptr)
+				return;
+
+			Running = false;
+			if (PumpThread->joinable())
+				PumpThread->join();
+			delete PumpThread;
+			PumpThread = nullptr;
+		}
+
+		bool IsRunning() const
+		{
+			return PumpThread != nullptr;
+		}
+
+		const SerialLinkConfig& GetConfig() const
+		{
+			return Config;
+		}
+
+		// Bytes delivered to the destination RX.
+		uint64_t GetBytesTransferred() const
+		{
+			return BytesTransferred.load(std::memory_order_relaxed);
+		}
+
+		// Bytes lost because the destination RX was full (without flow control).
+		uint64_t GetBytesDropped() const
+		{
+			return BytesDropped.load(std::memory_order_relaxed);
+		}
+
+	private:
+		void Pump()
+		{
+			while (Running)
+			{
+				const uint32_t txId = Source.GetTxId();
+
+				Schedule(Now());
+				const int64_t next = Deliver(Now());
+
+				uint32_t waitMillis = IdleWaitMillis;
+				if (next >= 0)
+				{
+					// Wake for the next arrival; bytes due within the same millisecond go together.
+					const int64_t delay = next - Now();
+					waitMillis = delay <= 0 ? 1 : static_cast<uint32_t>(std::min<int64_t>((delay + 999999) / 1000000, IdleWaitMillis));
+					std::this_thread::sleep_for(std::chrono::milliseconds(waitMillis));
+				}
+				else
+				{
+					Source.waitForTx(txId, waitMillis);
+				}
+			}
+		}
+
+		// Puts bytes newly written to the source raw channel on the wire, after those already sent.
+		void Schedule(const int64_t now)
+		{
+			const size_t available = Source.availableTxRaw();
+			if (available <= Scheduled)
+				return;
+
+			const size_t count = available - Scheduled;
+			const int64_t start = std::max(now, WireFree);
+			Pending.push_back({ count, start });
+			Scheduled += count;
+			WireFree = start + static_cast<int64_t>(count) * ByteNanos;
+		}
+
+		// Moves arrived bytes into the destination RX.
+		// Returns the arrival time of the next pending byte, -1 if none is pending.
+		int64_t Deliver(const int64_t now)
+		{
+			while (!Pending.empty())
+			{
+				Segment& segment = Pending.front();
+
+				size_t due;
+				const int64_t elapsed = now - LatencyNanos - segment.Start;
+				if (ByteNanos == 0)
+					due = elapsed >= 0 ? segment.Count : 0;
+				else
+					due = elapsed > 0 ? static_cast<size_t>(std::min<int64_t>(elapsed / ByteNanos, static_cast<int64_t>(segment.Count))) : 0;
+
+				const size_t sent = Transfer(due);
+				segment.Count -= sent;
+				segment.Start += static_cast<int64_t>(sent) * ByteNanos;
+				Scheduled -= sent;
+
+				if (sent < due)
+				{
+					// Destination full with flow control, retry shortly.
+					return now;
+				}
+
+				if (segment.Count > 0)
+					return segment.Start + ByteNanos + LatencyNanos;
+
+				Pending.pop_front();
+			}
+			return -1;
+		}
+
+		// Copies up to count bytes from the source raw spans into the destination RX ring.
+		// Returns bytes released from the source.
+		size_t Transfer(const size_t count)
+		{
+			size_t total = 0;
+			const uint8_t* data;
+			size_t length;
+			while (total < count && (length = Source.peekTxRaw(data)) > 0)
+			{
+				length = std::min(length, count - total);
+
+				const size_t accepted = Destination.Rx(data, length);
+				BytesTransferred.fetch_add(accepted, std::memory_order_relaxed);
+
+				if (accepted < length && Config.FlowControl)
+				{
+					Source.consumeTxRaw(accepted);
+					return total + accepted;
+				}
+
+				BytesDropped.fetch_add(length - accepted, std::memory_order_relaxed);
+				Source.consumeTxRaw(length);
+				total += length;
+			}
+			return total;
+		}
+
+		static int64_t Now()
+		{
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+		}
+	};
+
+	/// <summary>
+	/// Crossover cable between two ports: A's TX into B's RX and B's TX into A's RX.
+	/// </summary>
+	class SerialCrossover
+	{
+	private:
+		SerialLink AToB;
+		SerialLink BToA;
+
+	public:
+		SerialCrossover(Hal::ArduinoSerialPort& a, Hal::ArduinoSerialPort& b, const SerialLinkConfig& config = SerialLinkConfig())
+			: AToB(a, b, config)
+			, BToA(b, a, config)
+		{
+		}
+
+		// Starts both directions.
+		bool Start()
+		{
+			if (!AToB.Start())
+				return false;
+			if (!BToA.Start())
+			{
+				AToB.Stop();
+				return false;
+			}
+			return true;
+		}
+
+		void Stop()
+		{
+			AToB.Stop();
+			BToA.Stop();
+		}
+
+		SerialLink& GetAToB() { return AToB; }
+		SerialLink& GetBToA() { return BToA; }
+	};
+}
@@ -6,57 +6,107 @@
 #include <winrt/Windows.UI.Core.h> 
 #include <winrt/Windows.UI.Xaml.Media.h>
 #include <winrt/Windows.UI.Xaml.Controls.h>
+#include <winrt/Windows.UI.Xaml.Documents.h>
 #include <winrt/Windows.System.Threading.h>
 #include <winrt/Windows.Foundation.h>
 #include <winrt/Windows.System.h>
 
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <atomic>
+
 namespace ArduinoWindowsHost
 {
 	/// <summary>
-	/// Periodically transfers buffered serial TX output (collected from an
-	/// ArduinoSerialPort) into a XAML TextBlock, optionally
-	/// keeping an associated ScrollViewer scrolled to the bottom.
+	/// Transfers serial TX output (collected from an ArduinoSerialPort) into a
+	/// XAML TextBlock, optionally keeping an associated ScrollViewer scrolled to the bottom.
 	/// 
 	/// Intended use-case: implement a lightweight Serial Monitor view in a
-	/// WinRT / UWP XAML UI without wiring explicit events from the serial
-	/// backend. A background ThreadPoolTimer polls at a fixed interval
-	/// (see <typeparamref name="PollPeriodMicros"/>) and, when the ports
-	/// transmission state id changes, marshals a UI update via
+	/// WinRT / UWP XAML UI. The adapter subscribes to the port as an ISerialListener,
+	/// so nothing runs while the sketch is silent. The first line completed after a
+	/// refresh arms a one-shot ThreadPoolTimer (see <typeparamref name="RefreshPeriodMicros"/>),
+	/// further lines are coalesced into the same refresh, which marshals a UI update via
 	/// CoreDispatcher::TryRunAsync.
+	/// 
+	/// Updates are incremental: only lines after the adapter's TX cursor are
+	/// read and appended to the TextBlock as a new Run, so each refresh costs
+	/// O(new lines). The oldest Runs are trimmed to the port's line capacity.
+	/// 
+	/// Timer callbacks and queued UI updates hold shared state, never the adapter itself:
+	/// Stop() waits for a running refresh, and later callbacks find the adapter gone.
 	/// </summary>
-	/// <typeparam name="PollPeriodMicros">
-	/// Poll period in microseconds (default 50,000 = 50 ms). Lower values increase
-	/// UI refresh responsiveness at the cost of more wake-ups.
+	/// <typeparam name="RefreshPeriodMicros">
+	/// Coalescing window in microseconds (default 50,000 = 50 ms), the UI is refreshed at most
+	/// once per window. Lower values increase UI responsiveness at the cost of more dispatches.
 	/// </typeparam>
-	template<const uint32_t PollPeriodMicros = 50000>
-	class SerialOutputAdapter
+	template<const uint32_t RefreshPeriodMicros = 50000>
+	class SerialOutputAdapter : private ArduinoWindowsHost::Hal::ISerialListener
 	{
 	private:
-		// Periodic timer used for polling serial TX state.
-		winrt::Windows::System::Threading::ThreadPoolTimer PollTimer{ nullptr };
+		// Shared with timer callbacks, which may still fire after the adapter is gone.
+		struct RefreshAnchor
+		{
+			// Serializes refreshes with Stop(), guards Adapter and the adapter's read state.
+			std::mutex ReadMutex{};
+
+			// Set by Start(), cleared by Stop().
+			SerialOutputAdapter* Adapter = nullptr;
+		};
+
+		// Shared with queued UI updates; replaced on Start(), released on Stop().
+		struct UiTargets
+		{
+			winrt::Windows::UI::Xaml::Controls::TextBlock OutputTextBlock{ nullptr };
+			winrt::Windows::UI::Xaml::Controls::ScrollViewer OutputScroller{ nullptr };
+
+			// Line count of each displayed Run, oldest first (UI thread only).
+			std::deque<size_t> RunLines{};
+			size_t DisplayedLines = 0;
+		};
+
+	private:
+		// One-shot timer for the pending refresh (guarded by RefreshMutex).
+		winrt::Windows::System::Threading::ThreadPoolTimer RefreshTimer{ nullptr };
+
+		// Guards timer (re)arming. Taken under the port's TX lock, so never held while reading the port.
+		std::mutex RefreshMutex{};
+
+		const std::shared_ptr<RefreshAnchor> Anchor;
+
+		// Set when new output arrived and a refresh is armed.
+		std::atomic<bool> UpdatePending{ false };
+
+		// Cleared on Stop(), so late notifications don't arm a timer.
+		std::atomic<bool> Running{ false };
 
 	private:
-		// Reference to the serial instance providing buffered lines and a TX state id.
+		// Reference to the serial instance providing buffered lines.
 		ArduinoWindowsHost::Hal::ArduinoSerialPort& SerialInstance;
 
 	private:
-		// UI targets (weak interface references - set to nullptr on Stop()).
-		winrt::Windows::UI::Xaml::Controls::ITextBlock OutputTextBlock{ nullptr };
-		winrt::Windows::UI::Xaml::Controls::ScrollViewer OutputScroller{ nullptr };
+		// UI targets and their dispatcher (guarded by Anchor->ReadMutex, released on Stop()).
+		std::shared_ptr<UiTargets> Ui{};
 		winrt::Windows::UI::Core::CoreDispatcher Dispatcher{ nullptr };
 
-		// Cached last seen TX state id (invalid initial value forces first refresh).
-		uint32_t StateId = UINT32_MAX;
+		// TX log cursor, next line to read (guarded by Anchor->ReadMutex).
+		uint64_t Cursor = 0;
 
 		// Auto-scroll flag controlling whether scroller jumps to bottom.
-		bool AutoScrollEnabled = true;
+		std::atomic<bool> AutoScrollEnabled{ true };
 
 	public:
 		SerialOutputAdapter(ArduinoWindowsHost::Hal::ArduinoSerialPort& serialInstance)
-			: SerialInstance(serialInstance)
+			: Anchor(std::make_shared<RefreshAnchor>())
+			, SerialInstance(serialInstance)
 		{
 		}
 
+		~SerialOutputAdapter()
+		{
+			Stop();
+		}
+
 		// Returns current auto-scroll preference.
 		bool AutoScroll() const
 		{
@@ -70,7 +120,7 @@ namespace ArduinoWindowsHost
 		}
 
 		/// <summary>
-		/// Begin polling and binding to provided UI elements. 
+		/// Subscribes to the port and binds to the provided UI elements.
 		/// Must be called on the UI thread(captures CoreDispatcher).
 		/// </summary>
 		/// <param name="outputTextBlock"></param>
@@ -78,82 +128,155 @@ namespace ArduinoWindowsHost
 		void Start(winrt::Windows::UI::Xaml::Controls::TextBlock& outputTextBlock,
 			winrt::Windows::UI::Xaml::Controls::ScrollViewer& outputScroller)
 		{
-			Dispatcher = outputTextBlock.Dispatcher();
-			OutputTextBlock = outputTextBlock;
-			OutputScroller = outputScroller;
-
-			using winrt::Windows::System::Threading::ThreadPoolTimer;
-
-			StateId = UINT32_MAX;
-			PollTimer = ThreadPoolTimer::CreatePeriodicTimer([this](ThreadPoolTimer const&)
-				{
-					// Poll for TX data changes.
-					const uint32_t stateId = SerialInstance.GetTxId();
+			// Fresh targets, so updates queued for a previous Start() are dropped.
+			const std::shared_ptr<UiTargets> ui = std::make_shared<UiTargets>();
+			ui->OutputTextBlock = outputTextBlock;
+			ui->OutputScroller = outputScroller;
+			ui->OutputTextBlock.Inlines().Clear();
 
-					if (StateId != stateId)
-					{
-						// New data available.
-						StateId = stateId;
+			{
+				std::lock_guard<std::mutex> lock(Anchor->ReadMutex);
+				Dispatcher = outputTextBlock.Dispatcher();
+				Ui = ui;
+				Cursor = SerialInstance.GetTxOldestCursor();
+				Anchor->Adapter = this;
+			}
 
-						std::vector<std::string> txData = SerialInstance.getBufferedLines();
+			Running = true;
+			SerialInstance.addListener(*this);
 
-						if (Dispatcher != nullptr)
-						{
-							// Marshal UI update.
-							Dispatcher.TryRunAsync(
-								winrt::Windows::UI::Core::CoreDispatcherPriority::Low,
-								winrt::Windows::UI::Core::DispatchedHandler([this, txData]
-									{
-										if (OutputTextBlock != nullptr)
-										{
-											std::string allText;
-											allText.reserve(
-												txData.size() * 2 + 64); // light heuristic to reduce reallocs
-
-											for (const auto& line : txData)
-											{
-												allText.append(line);
-												allText.append("\n");
-											}
-											OutputTextBlock.Text(winrt::to_hstring(allText));
-											if (AutoScrollEnabled && OutputScroller != nullptr)
-											{
-												OutputScroller.UpdateLayout();
-												double bottom = OutputScroller.ScrollableHeight();
-												OutputScroller.ChangeView(nullptr, bottom, nullptr, true);
-											}
-										}
-									})
-							);
-						}
-					}
-					else
-					{
-						// No new data; still honor auto-scroll if enabled (optional).
-						if (AutoScrollEnabled && OutputScroller != nullptr)
-						{
-							OutputScroller.UpdateLayout();
-							double bottom = OutputScroller.ScrollableHeight();
-							if (bottom > 0)
-								OutputScroller.ChangeView(nullptr, bottom, nullptr, true);
-						}
-					}
-				}, std::chrono::microseconds(PollPeriodMicros));
+			// Show what the port already holds.
+			ArmRefresh();
 		}
 
 		/// <summary>
-		/// Stops polling and releases references to UI objects.
+		/// Unsubscribes, cancels any pending refresh and releases references to UI objects.
+		/// Returns after a refresh already running completes; UI updates it queued are dropped.
 		/// </summary>
 		void Stop()
 		{
-			if (PollTimer)
 			{
-				PollTimer.Cancel();
-				PollTimer = nullptr;
+				// Waits for a refresh already running; timer Cancel() doesn't.
+				std::lock_guard<std::mutex> lock(Anchor->ReadMutex);
+				Running = false;
+				Anchor->Adapter = nullptr;
+				Ui = nullptr;
+				Dispatcher = nullptr;
+			}
+			SerialInstance.removeListener(*this);
+
+			std::lock_guard<std::mutex> lock(RefreshMutex);
+			if (RefreshTimer)
+			{
+				RefreshTimer.Cancel();
+				RefreshTimer = nullptr;
+			}
+			UpdatePending = false;
+		}
+
+	private:
+		// Runs under the port's TX lock: only flag and arm, the refresh reads the port later.
+		void OnSerialTxLine(const uint8_t portId, const Hal::SerialTxLineInfo& info, const char* line, const size_t length) final
+		{
+			ArmRefresh();
+		}
+
+		void OnSerialTxFlush(const uint8_t portId) final
+		{
+			ArmRefresh();
+		}
+
+		void ArmRefresh()
+		{
+			if (!Running || UpdatePending.exchange(true))
+				return; // Already armed, this change is picked up by that refresh.
+
+			using winrt::Windows::System::Threading::ThreadPoolTimer;
+
+			std::lock_guard<std::mutex> lock(RefreshMutex);
+			RefreshTimer = ThreadPoolTimer::CreateTimer([anchor = Anchor](ThreadPoolTimer const&)
+				{
+					std::lock_guard<std::mutex> lock(anchor->ReadMutex);
+					if (anchor->Adapter != nullptr)
+						anchor->Adapter->Refresh();
+				}, std::chrono::microseconds(RefreshPeriodMicros));
+		}
+
+		// Timer thread, under Anchor->ReadMutex: copies out new lines and marshals the UI update.
+		void Refresh()
+		{
+			{
+				std::lock_guard<std::mutex> lock(RefreshMutex);
+
+				// Clear before reading, so lines completed from here on arm a new refresh.
+				UpdatePending = false;
+				RefreshTimer = nullptr;
+			}
+
+			if (!Running)
+				return;
+
+			// Copy out only the lines added since the last refresh.
+			std::string txText;
+			const Hal::SerialTxCursor txRead = SerialInstance.visitLinesFrom(Cursor,
+				[&txText](const uint64_t, const char* data, const size_t length)
+				{
+					txText.append(data, length);
+					txText.append("\n");
+				});
+			Cursor = txRead.Next;
+
+			if ((txRead.Lines > 0 || txRead.Missed) && Dispatcher != nullptr)
+			{
+				const size_t lineCapacity = SerialInstance.GetTxLineCapacity();
+				const bool autoScroll = AutoScrollEnabled;
+
+				// Marshal UI update. It may run after Stop() or the adapter's destruction, so it only holds the targets weakly.
+				Dispatcher.TryRunAsync(
+					winrt::Windows::UI::Core::CoreDispatcherPriority::Low,
+					winrt::Windows::UI::Core::DispatchedHandler([target = std::weak_ptr<UiTargets>(Ui), txText = std::move(txText), txRead, lineCapacity, autoScroll]
+						{
+							const std::shared_ptr<UiTargets> ui = target.lock();
+							if (ui != nullptr && ui->OutputTextBlock != nullptr)
+							{
+								auto inlines = ui->OutputTextBlock.Inlines();
+
+								// Lines were flushed or overran the buffer, restart from what the port holds.
+								if (txRead.Missed)
+								{
+									inlines.Clear();
+									ui->RunLines.clear();
+									ui->DisplayedLines = 0;
+								}
+
+								if (txRead.Lines > 0)
+								{
+									winrt::Windows::UI::Xaml::Documents::Run run{};
+									run.Text(winrt::to_hstring(txText));
+									inlines.Append(run);
+									ui->RunLines.push_back(txRead.Lines);
+									ui->DisplayedLines += txRead.Lines;
+
+									// Trim the oldest Runs beyond the port's line capacity.
+									while (ui->RunLines.size() > 1
+										&& (ui->DisplayedLines - ui->RunLines.front()) >= lineCapacity)
+									{
+										inlines.RemoveAt(0);
+										ui->DisplayedLines -= ui->RunLines.front();
+										ui->RunLines.pop_front();
+									}
+								}
+
+								if (autoScroll && ui->OutputScroller != nullptr)
+								{
+									ui->OutputScroller.UpdateLayout();
+									double bottom = ui->OutputScroller.ScrollableHeight();
+									ui->OutputScroller.ChangeView(nullptr, bottom, nullptr, true);
+								}
+							}
+						})
+				);
 			}
-			OutputTextBlock = nullptr;
-			OutputScroller = nullptr;
-			Dispatcher = nullptr;
 		}
 	};
 }
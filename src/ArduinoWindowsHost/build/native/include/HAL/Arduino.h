@@ -6,29 +6,26 @@
 
 #include "ArduinoIo.hpp"
 #include "ArduinoSerialPort.hpp"
+#include "SerialFraming.hpp"
+#include "ArduinoTimer.hpp"
+#include "HalContext.hpp"
 
 namespace ArduinoWindowsHost
 {
 	namespace Hal
 	{
-		namespace State
-		{
-			volatile static uint32_t BootMillis = 0;
-			volatile static uint32_t BootMicros = 0;
-		}
-
 		static uint32_t millis()
 		{
 			using namespace std::chrono;
 
-			return static_cast<uint32_t>(duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count()) - State::BootMillis;
+			return static_cast<uint32_t>(duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count()) - HalContext::Current().BootMillis.load(std::memory_order_relaxed);
 		}
 
 		static uint32_t micros()
 		{
 			using namespace std::chrono;
 
-			return static_cast<uint32_t>(duration_cast<microseconds>(system_clock::now().time_since_epoch()).count()) - State::BootMicros;
+			return static_cast<uint32_t>(duration_cast<microseconds>(system_clock::now().time_since_epoch()).count()) - HalContext::Current().BootMicros.load(std::memory_order_relaxed);
 		}
 
 		static void delay(const uint32_t duration)
@@ -56,69 +53,81 @@ namespace ArduinoWindowsHost
 		}
 	}
 
-	namespace Hal
-	{
-		namespace Config
-		{
-			static constexpr size_t SerialLineCapacity = 2048;
-		}
-
-		static ArduinoSerialPort Serial(0, Config::SerialLineCapacity);
-		static ArduinoSerialPort Serial1(1, Config::SerialLineCapacity);
-		static ArduinoSerialPort Serial2(1, Config::SerialLineCapacity);
-	}
-
 	namespace Hal
 	{
 		static constexpr uint8_t LED_BUILTIN = 13;
 
-		namespace Config
+		static void digitalWrite(const uint8_t pin, const WiringState state)
 		{
-			static constexpr uint8_t IoCount = 32;
+			HalContext::Current().Io.digitalWrite(pin, state);
 		}
 
-		namespace State
+		static uint8_t digitalRead(const uint8_t pin)
 		{
-			static ArduinoIo<Config::IoCount> IoHal{};
+			return HalContext::Current().Io.digitalRead(pin);
 		}
 
-		static void digitalWrite(const uint8_t pin, const WiringState state)
+		static void pinMode(const uint8_t pin, const WiringPinMode mode)
 		{
-			State::IoHal.digitalWrite(pin, state);
+			HalContext::Current().Io.pinMode(pin, mode);
 		}
+	}
 
-		static uint8_t digitalRead(const uint8_t pin)
+	namespace Hal
+	{
+		// Blocks emulated ISRs until interrupts() is called.
+		static void noInterrupts()
 		{
-			return State::IoHal.digitalRead(pin);
+			if (!InterruptState::Disabled())
+			{
+				InterruptState::Lock().lock();
+				InterruptState::Disabled() = true;
+			}
 		}
 
-		static void pinMode(const uint8_t pin, const WiringPinMode mode)
+		static void interrupts()
 		{
-			State::IoHal.pinMode(pin, mode);
+			if (InterruptState::Disabled())
+			{
+				InterruptState::Disabled() = false;
+				InterruptState::Lock().unlock();
+			}
 		}
 	}
 
 	namespace Hal
 	{
+		// Restarts the bound board: boot clock, pins, loop counter, interrupts, timer and serial buffers.
 		static void reset()
 		{
 			using namespace std::chrono;
 
-			State::BootMillis = static_cast<uint32_t>(duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count());
-			State::BootMicros = static_cast<uint32_t>(duration_cast<microseconds>(system_clock::now().time_since_epoch()).count());
-
-			State::IoHal.reset();
-			Serial.flushRx();
-			Serial.flushTx();
-			Serial1.flushRx();
-			Serial1.flushTx();
-			Serial2.flushRx();
-			Serial2.flushTx();
+			HalContext& hal = HalContext::Current();
+			hal.BootMillis = static_cast<uint32_t>(duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count());
+			hal.BootMicros = static_cast<uint32_t>(duration_cast<microseconds>(system_clock::now().time_since_epoch()).count());
+
+			hal.Io.reset();
+			hal.Iteration.store(0, std::memory_order_relaxed);
+			interrupts();
+			hal.Timer.detachInterrupt();
+			hal.Timer.resetStatistics();
+			for (uint8_t i = 0; i < hal.GetUartCount(); i++)
+			{
+				hal.GetUart(i).flushRx();
+				hal.GetUart(i).flushTx();
+			}
 		}
 	}
 }
 
 using namespace ArduinoWindowsHost::Hal;
 
+// Board peripherals of the host running on this thread (see HalContext).
+#define Serial (::ArduinoWindowsHost::Hal::HalContext::Current().Uart0)
+#define Serial1 (::ArduinoWindowsHost::Hal::HalContext::Current().Uart1)
+#define Serial2 (::ArduinoWindowsHost::Hal::HalContext::Current().Uart2)
+#define Serial3 (::ArduinoWindowsHost::Hal::HalContext::Current().Uart3)
+#define Timer1 (::ArduinoWindowsHost::Hal::HalContext::Current().Timer)
+
 #define PROGMEM
 #define F(a) (a)
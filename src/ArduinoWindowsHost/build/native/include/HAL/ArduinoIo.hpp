@@ -1,7 +1,8 @@
 #pragma once
 
-
 #include <stdint.h>
+#include <atomic>
+#include <thread>
 
 namespace ArduinoWindowsHost
 {
@@ -23,50 +24,325 @@ namespace ArduinoWindowsHost
 			HIGH
 		} WiringState;
 
-		template<uint8_t IO_COUNT = 32>
-		struct ArduinoIo
+		/// <summary>
+		/// Pin table of an emulated board, over storage provided by ArduinoIo.
+		/// Sized at run time, so one HalContext type serves every board profile.
+		/// - Levels are packed 32 pins per atomic word, modes 8 pins per word (4 bits each).
+		/// - Every change bumps the counter of its 32 pin word, so observers diff only the words that changed.
+		/// - Writers go through a seqlock, readers never block: GetSnapshot() retries until it copied
+		///   the whole table between two writes. Writes that change nothing skip it.
+		/// </summary>
+		class ArduinoPins
 		{
-			struct PinState
+		public:
+			static constexpr uint8_t PinsPerWord = 32;
+			static constexpr uint8_t ModesPerWord = 8;
+			static constexpr uint8_t MaxLevelWords = (UINT8_MAX + PinsPerWord - 1) / PinsPerWord;
+			static constexpr uint8_t MaxModeWords = (UINT8_MAX + ModesPerWord - 1) / ModesPerWord;
+
+			// Consistent copy of the whole pin table, see GetSnapshot().
+			struct Snapshot
 			{
-				volatile uint8_t Mode = INPUT; // Default to input.
-				volatile uint8_t State = LOW;  // Default to low.
+				uint32_t Sequence = 0;
+				uint8_t Count = 0;
+				uint32_t Levels[MaxLevelWords]{};
+				uint32_t Modes[MaxModeWords]{};
+				uint32_t Changes[MaxLevelWords]{};
+
+				uint8_t GetLevel(const uint8_t pin) const
+				{
+					return (Levels[pin / PinsPerWord] >> (pin % PinsPerWord)) & 1;
+				}
+
+				WiringPinMode GetMode(const uint8_t pin) const
+				{
+					return static_cast<WiringPinMode>((Modes[pin / ModesPerWord] >> ((pin % ModesPerWord) * 4)) & 0xF);
+				}
+
+				uint8_t GetWordCount() const
+				{
+					return static_cast<uint8_t>((Count + PinsPerWord - 1) / PinsPerWord);
+				}
+
+				// Pins of word (bit n is pin word * 32 + n) whose level or mode differs from previous.
+				// 0 when the word's counter didn't move. A moved counter with no differing pin means
+				// pins changed and changed back in between.
+				uint32_t GetChangedPins(const Snapshot& previous, const uint8_t word) const
+				{
+					if (Changes[word] == previous.Changes[word])
+						return 0;
+
+					uint32_t changed = Levels[word] ^ previous.Levels[word];
+					for (uint8_t i = 0; i < PinsPerWord / ModesPerWord; i++)
+					{
+						const uint8_t modeWord = static_cast<uint8_t>(word * (PinsPerWord / ModesPerWord) + i);
+						uint32_t modes = Modes[modeWord] ^ previous.Modes[modeWord];
+						for (uint8_t pin = 0; modes != 0; pin++, modes >>= 4)
+						{
+							if (modes & 0xF)
+								changed |= uint32_t(1) << (i * ModesPerWord + pin);
+						}
+					}
+					return changed;
+				}
 			};
 
-			PinState State[IO_COUNT]{};
+		private:
+			std::atomic<uint32_t>* const Levels;
+			std::atomic<uint32_t>* const Modes;
+			std::atomic<uint32_t>* const Changes;
+			const uint8_t Count;
 
-			volatile uint32_t StateId = 0;
+			// Seqlock: odd while a writer is updating the table.
+			std::atomic<uint32_t> Sequence{ 0 };
 
-			void digitalWrite(const uint8_t pin, const WiringState state)
+		public:
+			ArduinoPins(std::atomic<uint32_t>* levels, std::atomic<uint32_t>* modes, std::atomic<uint32_t>* changes, const uint8_t count)
+				: Levels(levels)
+				, Modes(modes)
+				, Changes(changes)
+				, Count(count)
 			{
-				if (pin < IO_COUNT && State[pin].Mode == OUTPUT)
-					State[pin].State = state != LOW;
+			}
+
+			ArduinoPins(const ArduinoPins&) = delete;
+			ArduinoPins& operator=(const ArduinoPins&) = delete;
 
-				StateId++;
+		public:
+			// Drives an output pin. Ignored on inputs, use SetInput() for those.
+			void digitalWrite(const uint8_t pin, const WiringState state)
+			{
+				if (pin < Count && IsOutput(GetMode(pin)))
+					setLevel(pin, state != LOW, true);
 			}
 
+			// Reads the pin level, whatever its mode.
+			// OUTPUT pins read back the level they drive, as on AVR; they used to read LOW.
 			uint8_t digitalRead(const uint8_t pin) const
 			{
-				if (pin < IO_COUNT && State[pin].Mode == INPUT)
-					return State[pin].State * 1;
-				else
-					return 0;
+				return GetLevel(pin);
 			}
 
+			// Pull-ups and pull-downs set the level an undriven input reads.
 			void pinMode(const uint8_t pin, const WiringPinMode mode)
 			{
-				if (pin < IO_COUNT)
-					State[pin].Mode = (mode == OUTPUT) * OUTPUT;
-				StateId++;
+				if (pin >= Count)
+					return;
+
+				// Lock-free fast path for the common no-op.
+				if (GetMode(pin) == mode && (GetLevel(pin) != 0) == modeLevel(pin, mode))
+					return;
+
+				// SetInput() may have moved the level since: check again, owning the table.
+				const uint32_t sequence = beginWrite();
+				const bool level = modeLevel(pin, mode);
+				if (GetMode(pin) == mode && (GetLevel(pin) != 0) == level)
+				{
+					abortWrite(sequence);
+					return;
+				}
+
+				storeMode(pin, mode);
+				storeLevel(pin, level);
+				bumpChanges(pin / PinsPerWord);
+				endWrite(sequence);
 			}
 
+			// All pins back to LOW inputs.
 			void reset()
 			{
-				for (uint8_t i = 0; i < IO_COUNT; ++i)
+				const uint32_t sequence = beginWrite();
+				for (uint8_t word = 0; word < GetModeWordCount(); word++)
+					Modes[word].store(InputModes, std::memory_order_relaxed);
+				for (uint8_t word = 0; word < GetWordCount(); word++)
+				{
+					Levels[word].store(0, std::memory_order_relaxed);
+					bumpChanges(word);
+				}
+				endWrite(sequence);
+			}
+
+		public:
+			// Drives an input pin from outside the sketch (UI, test harness). Ignored on outputs.
+			void SetInput(const uint8_t pin, const WiringState state)
+			{
+				if (pin < Count && !IsOutput(GetMode(pin)))
+					setLevel(pin, state != LOW, false);
+			}
+
+			uint8_t GetLevel(const uint8_t pin) const
+			{
+				if (pin >= Count)
+					return LOW;
+				return (Levels[pin / PinsPerWord].load(std::memory_order_relaxed) >> (pin % PinsPerWord)) & 1;
+			}
+
+			WiringPinMode GetMode(const uint8_t pin) const
+			{
+				if (pin >= Count)
+					return INPUT;
+				return static_cast<WiringPinMode>((Modes[pin / ModesPerWord].load(std::memory_order_relaxed) >> ((pin % ModesPerWord) * 4)) & 0xF);
+			}
+
+			uint8_t GetCount() const
+			{
+				return Count;
+			}
+
+			uint8_t GetWordCount() const
+			{
+				return static_cast<uint8_t>((Count + PinsPerWord - 1) / PinsPerWord);
+			}
+
+			// Advances by 2 per change, a cheap "anything changed?" poll before taking a snapshot.
+			uint32_t GetSequence() const
+			{
+				return Sequence.load(std::memory_order_acquire) & ~uint32_t(1);
+			}
+
+			/// <summary>
+			/// Copies levels, modes and change counters of every pin as of one instant, lock-free.
+			/// Retries while a write overlaps the copy; never blocks the sketch.
+			/// </summary>
+			void GetSnapshot(Snapshot& snapshot) const
+			{
+				snapshot.Count = Count;
+				uint32_t sequence;
+				do
 				{
-					State[i].Mode = INPUT;
-					State[i].State = LOW;
+					sequence = Sequence.load(std::memory_order_acquire);
+					if (sequence & 1)
+					{
+						std::this_thread::yield();
+						continue;
+					}
+
+					for (uint8_t word = 0; word < GetWordCount(); word++)
+					{
+						snapshot.Levels[word] = Levels[word].load(std::memory_order_relaxed);
+						snapshot.Changes[word] = Changes[word].load(std::memory_order_relaxed);
+					}
+					for (uint8_t word = 0; word < GetModeWordCount(); word++)
+						snapshot.Modes[word] = Modes[word].load(std::memory_order_relaxed);
+
+					std::atomic_thread_fence(std::memory_order_acquire);
+				} while ((sequence & 1) || Sequence.load(std::memory_order_relaxed) != sequence);
+
+				snapshot.Sequence = sequence;
+			}
+
+		private:
+			// Mode nibbles of 8 INPUT pins.
+			static constexpr uint32_t InputModes = uint32_t(INPUT) * 0x11111111u;
+
+			static bool IsOutput(const WiringPinMode mode)
+			{
+				return mode == OUTPUT || mode == OUTPUT_OPEN_DRAIN;
+			}
+
+			uint8_t GetModeWordCount() const
+			{
+				return static_cast<uint8_t>((Count + ModesPerWord - 1) / ModesPerWord);
+			}
+
+			// Level pin takes in mode: pulled up or down, else unchanged.
+			bool modeLevel(const uint8_t pin, const WiringPinMode mode) const
+			{
+				if (mode == INPUT_PULLUP)
+					return true;
+				else if (mode == INPUT_PULLDOWN)
+					return false;
+				else
+					return GetLevel(pin) != 0;
+			}
+
+			// Drives pin if modeOutput still matches its mode once the table is owned (see digitalWrite() and SetInput()).
+			void setLevel(const uint8_t pin, const bool level, const bool modeOutput)
+			{
+				// Unchanged levels skip the seqlock and don't count as changes.
+				if ((GetLevel(pin) != 0) == level)
+					return;
+
+				// Another writer (SetInput() vs the sketch, pinMode()) may have got there first: check again, owning the table.
+				const uint32_t sequence = beginWrite();
+				if ((GetLevel(pin) != 0) == level || IsOutput(GetMode(pin)) != modeOutput)
+				{
+					abortWrite(sequence);
+					return;
 				}
-				StateId++;
+
+				storeLevel(pin, level);
+				bumpChanges(pin / PinsPerWord);
+				endWrite(sequence);
+			}
+
+			// Writer side of the seqlock: owns the table until endWrite(). Serializes the loop thread with SetInput() callers.
+			uint32_t beginWrite()
+			{
+				uint32_t sequence = Sequence.load(std::memory_order_relaxed);
+				while (true)
+				{
+					if (sequence & 1)
+					{
+						std::this_thread::yield();
+						sequence = Sequence.load(std::memory_order_relaxed);
+					}
+					else if (Sequence.compare_exchange_weak(sequence, sequence + 1, std::memory_order_acquire, std::memory_order_relaxed))
+						break;
+				}
+				std::atomic_thread_fence(std::memory_order_release);
+				return sequence + 1;
+			}
+
+			void endWrite(const uint32_t sequence)
+			{
+				Sequence.store(sequence + 1, std::memory_order_release);
+			}
+
+			// Releases the table without a change: the sequence goes back, so a no-op isn't seen as one.
+			void abortWrite(const uint32_t sequence)
+			{
+				Sequence.store(sequence - 1, std::memory_order_release);
+			}
+
+			// Table stores, only between beginWrite() and endWrite().
+			void storeLevel(const uint8_t pin, const bool level)
+			{
+				std::atomic<uint32_t>& word = Levels[pin / PinsPerWord];
+				const uint32_t bit = uint32_t(1) << (pin % PinsPerWord);
+				const uint32_t levels = word.load(std::memory_order_relaxed);
+				word.store(level ? (levels | bit) : (levels & ~bit), std::memory_order_relaxed);
+			}
+
+			void storeMode(const uint8_t pin, const WiringPinMode mode)
+			{
+				std::atomic<uint32_t>& word = Modes[pin / ModesPerWord];
+				const uint8_t shift = (pin % ModesPerWord) * 4;
+				const uint32_t modes = word.load(std::memory_order_relaxed);
+				word.store((modes & ~(uint32_t(0xF) << shift)) | (uint32_t(mode) << shift), std::memory_order_relaxed);
+			}
+
+			void bumpChanges(const uint8_t word)
+			{
+				Changes[word].store(Changes[word].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			}
+		};
+
+		template<uint8_t IO_COUNT = 32>
+		class ArduinoIo : public ArduinoPins
+		{
+			static_assert(IO_COUNT > 0, "A board needs at least one pin.");
+
+		private:
+			std::atomic<uint32_t> LevelWords[(IO_COUNT + PinsPerWord - 1) / PinsPerWord]{};
+			std::atomic<uint32_t> ModeWords[(IO_COUNT + ModesPerWord - 1) / ModesPerWord]{};
+			std::atomic<uint32_t> ChangeWords[(IO_COUNT + PinsPerWord - 1) / PinsPerWord]{};
+
+		public:
+			ArduinoIo()
+				: ArduinoPins(LevelWords, ModeWords, ChangeWords, IO_COUNT)
+			{
+				reset();
 			}
 		};
 	}
@@ -0,0 +1,293 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <string>
+
+#include "NumberFormat.hpp"
+#include "PrintFormat.hpp"
+
+namespace ArduinoWindowsHost
+{
+	namespace Hal
+	{
+		class Print;
+
+		// Objects that know how to print themselves, as Arduino's Printable.
+		class Printable
+		{
+		public:
+			virtual ~Printable() = default;
+
+			virtual size_t printTo(Print& p) const = 0;
+		};
+
+		/// <summary>
+		/// Arduino Print base: formats text and numbers for any byte sink.
+		/// - Every print()/println() overload formats on the stack and ends in a single bulk write() call,
+		///   so sinks override write(const uint8_t*, size_t) as their one locking/timestamping point.
+		/// - write(uint8_t) is the minimal override, as on Arduino; the default bulk write() loops over it.
+		/// - println() terminates with "\r\n".
+		/// </summary>
+		class Print
+		{
+		public:
+			// println() of text up to this long is joined with its line ending into one write().
+			static constexpr size_t LineBufferSize = 128;
+
+		private:
+			int WriteError = 0;
+
+		public:
+			virtual ~Print() = default;
+
+			// Single byte sink, the minimal override.
+			virtual size_t write(const uint8_t value) = 0;
+
+			// Bulk sink, override to handle a whole print() call at once.
+			virtual size_t write(const uint8_t* buffer, size_t size)
+			{
+				size_t count = 0;
+				while (size--)
+				{
+					if (write(*buffer++))
+						count++;
+					else
+						break;
+				}
+				return count;
+			}
+
+			size_t write(const char* value)
+			{
+				if (value == nullptr)
+					return 0;
+				return write(reinterpret_cast<const uint8_t*>(value), strlen(value));
+			}
+
+			size_t write(const char* buffer, const size_t size)
+			{
+				return write(reinterpret_cast<const uint8_t*>(buffer), size);
+			}
+
+			// Bytes that can be written without blocking, 0 if unknown.
+			virtual int availableForWrite()
+			{
+				return 0;
+			}
+
+			// Waits for outgoing data to be sent.
+			virtual void flush() {}
+
+			int getWriteError() const
+			{
+				return WriteError;
+			}
+
+			void clearWriteError()
+			{
+				setWriteError(0);
+			}
+
+		public:
+			size_t print(const char value)
+			{
+				return write(static_cast<uint8_t>(value));
+			}
+
+			size_t print(const char* value)
+			{
+				return write(value);
+			}
+
+			size_t print(const __FlashStringHelper* value)
+			{
+				return write(reinterpret_cast<const char*>(value));
+			}
+
+			size_t print(const std::string& value)
+			{
+				return write(value.data(), value.size());
+			}
+
+			// C-string with explicit length (may contain nulls).
+			size_t print(const char* value, const size_t length)
+			{
+				if (value == nullptr)
+					return 0;
+				return write(value, length);
+			}
+
+			// Integers, in base DEC/HEX/OCT/BIN (0 writes the value as a raw byte).
+			// Types narrower than int are widened to 32 bits, as Arduino's long.
+			size_t print(const unsigned char value, const uint8_t base = DEC) { return printInteger(static_cast<uint32_t>(value), base, false); }
+			size_t print(const signed char value, const uint8_t base = DEC) { return printInteger(static_cast<int32_t>(value), base, false); }
+			size_t print(const unsigned short value, const uint8_t base = DEC) { return printInteger(static_cast<uint32_t>(value), base, false); }
+			size_t print(const short value, const uint8_t base = DEC) { return printInteger(static_cast<int32_t>(value), base, false); }
+			size_t print(const unsigned int value, const uint8_t base = DEC) { return printInteger(value, base, false); }
+			size_t print(const int value, const uint8_t base = DEC) { return printInteger(value, base, false); }
+			size_t print(const unsigned long value, const uint8_t base = DEC) { return printInteger(value, base, false); }
+			size_t print(const long value, const uint8_t base = DEC) { return printInteger(value, base, false); }
+			size_t print(const unsigned long long value, const uint8_t base = DEC) { return printInteger(value, base, false); }
+			size_t print(const long long value, const uint8_t base = DEC) { return printInteger(value, base, false); }
+
+			// Floating point, with digits fraction digits.
+			size_t print(const double value, const uint8_t digits = 2)
+			{
+				return printFloat(value, digits, false);
+			}
+
+			size_t print(const Printable& value)
+			{
+				return value.printTo(*this);
+			}
+
+		public:
+			size_t println()
+			{
+				return write("\r\n", 2);
+			}
+
+			size_t println(const char value)
+			{
+				const uint8_t line[3] = { static_cast<uint8_t>(value), '\r', '\n' };
+				return write(line, sizeof(line));
+			}
+
+			size_t println(const char* value)
+			{
+				if (value == nullptr)
+					return println();
+				return printLine(value, strlen(value));
+			}
+
+			size_t println(const __FlashStringHelper* value)
+			{
+				return println(reinterpret_cast<const char*>(value));
+			}
+
+			size_t println(const std::string& value)
+			{
+				return printLine(value.data(), value.size());
+			}
+
+			size_t println(const char* value, const size_t length)
+			{
+				if (value == nullptr)
+					return println();
+				return printLine(value, length);
+			}
+
+			size_t println(const unsigned char value, const uint8_t base = DEC) { return printInteger(static_cast<uint32_t>(value), base, true); }
+			size_t println(const signed char value, const uint8_t base = DEC) { return printInteger(static_cast<int32_t>(value), base, true); }
+			size_t println(const unsigned short value, const uint8_t base = DEC) { return printInteger(static_cast<uint32_t>(value), base, true); }
+			size_t println(const short value, const uint8_t base = DEC) { return printInteger(static_cast<int32_t>(value), base, true); }
+			size_t println(const unsigned int value, const uint8_t base = DEC) { return printInteger(value, base, true); }
+			size_t println(const int value, const uint8_t base = DEC) { return printInteger(value, base, true); }
+			size_t println(const unsigned long value, const uint8_t base = DEC) { return printInteger(value, base, true); }
+			size_t println(const long value, const uint8_t base = DEC) { return printInteger(value, base, true); }
+			size_t println(const unsigned long long value, const uint8_t base = DEC) { return printInteger(value, base, true); }
+			size_t println(const long long value, const uint8_t base = DEC) { return printInteger(value, base, true); }
+
+			size_t println(const double value, const uint8_t digits = 2)
+			{
+				return printFloat(value, digits, true);
+			}
+
+			size_t println(const Printable& value)
+			{
+				const size_t count = value.printTo(*this);
+				return count + println();
+			}
+
+		public:
+			/// <summary>
+			/// printf() with the format checked at compile time: printf(FMT("x=%d\n"), x).
+			/// A conversion/argument count or type mismatch fails the build.
+			/// Formats straight into stack chunks, most lines reach write() in a single call.
+			/// </summary>
+			template<typename Format, typename... Args,
+				typename std::enable_if<std::is_base_of<FormatLiteral, Format>::value, int>::type = 0>
+			size_t printf(const Format, const Args&... args)
+			{
+				static constexpr FormatArg::Kind Kinds[] = { FormatArgKind<typename std::decay<Args>::type>::value..., FormatArg::Kind::None };
+				static constexpr PrintFormat::Error Result = PrintFormat::Check(Format::value(), Kinds, sizeof...(Args));
+
+				static_assert(Result != PrintFormat::Error::MissingArgument, "printf: more conversions than arguments.");
+				static_assert(Result != PrintFormat::Error::ExtraArgument, "printf: more arguments than conversions.");
+				static_assert(Result != PrintFormat::Error::TypeMismatch, "printf: argument type doesn't match its conversion.");
+				static_assert(Result != PrintFormat::Error::BadConversion, "printf: unknown or unsupported conversion.");
+
+				const FormatArg values[] = { FormatArg(args)..., FormatArg() };
+				return PrintFormat::Format(*this, Format::value(), values, sizeof...(Args));
+			}
+
+			// A bare literal format would go unchecked: wrap it in FMT(), or call printfUnchecked() on purpose.
+			template<size_t N, typename... Args>
+			size_t printf(const char(&format)[N], const Args&... args)
+			{
+				static_assert(N == 0, "printf: use printf(FMT(\"...\"), ...) for a compile time checked format, or printfUnchecked() for a run time one.");
+				return 0;
+			}
+
+			// printf() with a run time format. Mismatched conversions print as "%!" plus the conversion.
+			template<typename... Args>
+			size_t printfUnchecked(const char* format, const Args&... args)
+			{
+				if (format == nullptr)
+					return 0;
+
+				const FormatArg values[] = { FormatArg(args)..., FormatArg() };
+				return PrintFormat::Format(*this, format, values, sizeof...(Args));
+			}
+
+		protected:
+			void setWriteError(const int error = 1)
+			{
+				WriteError = error;
+			}
+
+		private:
+			template<typename T>
+			size_t printInteger(const T value, const uint8_t base, const bool line)
+			{
+				char text[NumberFormat::MaxIntegerLength + 2];
+				size_t length = NumberFormat::FormatInteger(text, value, base);
+				if (line)
+					length += AppendLineEnd(text + length);
+				return write(text, length);
+			}
+
+			size_t printFloat(const double value, const uint8_t digits, const bool line)
+			{
+				char text[NumberFormat::MaxFloatLength + 2];
+				size_t length = NumberFormat::FormatFloat(text, value, digits);
+				if (line)
+					length += AppendLineEnd(text + length);
+				return write(text, length);
+			}
+
+			// Short lines are copied to join the line ending, so the sink sees one write().
+			size_t printLine(const char* value, const size_t length)
+			{
+				if (length <= LineBufferSize - 2)
+				{
+					char text[LineBufferSize];
+					memcpy(text, value, length);
+					return write(text, length + AppendLineEnd(text + length));
+				}
+
+				const size_t count = write(value, length);
+				return count + println();
+			}
+
+			static size_t AppendLineEnd(char* text)
+			{
+				text[0] = '\r';
+				text[1] = '\n';
+				return 2;
+			}
+		};
+	}
+}
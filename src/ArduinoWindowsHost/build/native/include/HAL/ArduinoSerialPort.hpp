@@ -4,78 +4,182 @@
 #include <vector>
 #include <string>
 #include <mutex>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <thread>
 #include <algorithm>
+#include <memory>
+#include <string.h>
+
+#include "SpscByteRing.hpp"
+#include "SerialLineLog.hpp"
+#include "ISerialListener.h"
+#include "SerialTiming.hpp"
+#include "ArduinoStream.hpp"
 
 namespace ArduinoWindowsHost
 {
 	namespace Hal
 	{
-		// Arduino flash string helper (F("...")) compatibility.
-		// On actual Arduino you would read from PROGMEM; here we treat it as normal C string.
-#if !defined(ARDUINO)
-		struct __FlashStringHelper; // forward (host)
-#endif
+		// Result of reading the TX log from a cursor.
+		struct SerialTxCursor
+		{
+			uint64_t Next = 0;		// Cursor to resume from on the next read.
+			size_t Lines = 0;		// Lines delivered.
+			bool Missed = false;	// Lines after the previous cursor were evicted or flushed before being read.
+		};
 
-		class ArduinoSerialPort
+		// TX line metadata: sequence, completion time (GetTxClock() nanoseconds) and host loop iteration.
+		using SerialTxLineInfo = SerialLineLog::LineInfo;
+
+		// Copied TX line with its metadata.
+		struct SerialTxLine
+		{
+			SerialTxLineInfo Info{};
+			std::string Text{};
+		};
+
+		class ArduinoSerialPort : public Stream
 		{
 		private:
 			mutable std::mutex m_mutex;
 
 			uint8_t PortId;
-			size_t LineCapacity;
 
-			size_t m_head = 0;   // next write index
-			size_t m_count = 0;  // number of valid entries
+			// Loop counter of the owning board (see HalContext), null for a standalone port.
+			const std::atomic<uint32_t>* m_iteration = nullptr;
+
+			// TX line log (guarded by m_mutex): completed lines plus the line assembled from successive print() calls.
+			SerialLineLog m_txLog;
+
+		private:
+			// --- RX ring (lock-free SPSC: Rx() producers -> sketch consumer) ---
+			SpscByteRing m_rxRing;
+
+			// Serializes Rx() callers only, so several feeder threads can share the single producer side.
+			// Never taken by the read path, unless a producer is blocked on backpressure.
+			std::mutex m_rxProducerMutex;
+
+			// Backpressure: when enabled, Rx() waits for the sketch to free space instead of dropping.
+			std::condition_variable m_rxSpaceCv;
+			std::atomic<bool> m_rxWaiting{ false };
+			bool m_rxBackpressure = false;
+			uint32_t m_rxBackpressureTimeout = UINT32_MAX;
 
-			// current (not-yet-terminated) line assembled from successive print() calls
-			std::string m_currentLine;
+			// Line terminator counted as Rx() accepts bytes, -1 when not counting.
+			std::atomic<int> m_rxTerminator{ -1 };
+			std::atomic<uint32_t> RxTerminators{ 0 };
 
-			// circular buffer storage
-			std::vector<std::string> m_lines;
+			// Overflow counters.
+			std::atomic<uint32_t> RxDropped{ 0 };
+			std::atomic<uint32_t> RxOverflows{ 0 };
+
+		public:
+			static constexpr uint8_t MaxListeners = 4;
 
 		private:
-			// --- RX circular buffer (fixed size, short) ---
-			static constexpr size_t RxBufferCapacity = 256;
-			char   m_rxBuffer[RxBufferCapacity]{};
-			size_t m_rxHead = 0;   // next write position
-			size_t m_rxTail = 0;   // next read position
-			size_t m_rxCount = 0;  // number of bytes s
+			// Lock-free subscriber slots, with an in-flight call count so removal can wait out running callbacks.
+			std::atomic<ISerialListener*> m_listeners[MaxListeners]{};
+			std::atomic<uint8_t> m_listenerCount{ 0 };
+			std::atomic<uint32_t> m_listenerCalls{ 0 };
+
+			// Sequence of the next TX line to publish to listeners (guarded by m_mutex).
+			uint64_t m_publishedSequence = 0;
+
+			// waitForTx()/waitForRx() support, only signalled while someone waits.
+			mutable std::mutex m_waitMutex;
+			mutable std::condition_variable m_waitCv;
+			mutable std::atomic<uint32_t> m_waiters{ 0 };
+
+			// Buffered TX mode: the owner thread's partial lines collect here, without locking.
+			// Written by the owner thread only; no owner (default id) when disabled.
+			std::atomic<std::thread::id> m_txBufferOwner{};
+			std::unique_ptr<char[]> m_txBuffer{};
+			size_t m_txBufferCapacity = 0;
+			size_t m_txBufferLength = 0;
+
+			// Raw TX channel: byte-exact copy of everything written, for binary protocols (null when disabled).
+			// Producers are serialized by m_txRawMutex, one consumer reads spans.
+			// Published through m_txRaw once enabled and never released before the port, so readers need no lock.
+			std::unique_ptr<SpscByteRing> m_txRawRing;
+			std::atomic<SpscByteRing*> m_txRaw{ nullptr };
+			std::mutex m_txRawMutex;
+			std::atomic<uint32_t> TxRawDropped{ 0 };
+
+			// Text lines are only logged while enabled, binary-only sketches may turn it off.
+			std::atomic<bool> m_txLineLog{ true };
+
+			// Optional baud rate model, metering writes and Rx() at the begin() baud rate.
+			SerialTimingModel m_timing;
 
 		private:
 			std::atomic<bool> m_ready{ false }; // added
 
-			volatile uint32_t TxId = 0;
-			volatile uint32_t RxId = 0;
-			volatile uint32_t LastRx = 0;
-			volatile uint32_t LastTx = 0;
+			std::atomic<uint32_t> TxId{ 0 };
+			std::atomic<uint32_t> RxId{ 0 };
+			std::atomic<uint32_t> LastRx{ 0 };
+			std::atomic<uint32_t> LastTx{ 0 };
 
 		public:
+			static constexpr size_t DefaultRxCapacity = 256;
+			static constexpr size_t DefaultTxCapacity = 64 * 1024;
+			static constexpr size_t DefaultTxBufferCapacity = 256;
+			static constexpr size_t DefaultTxRawCapacity = 0;
+			static constexpr size_t DefaultEnabledTxRawCapacity = 64 * 1024;
+
+		public:
+			// rxCapacity, txCapacity (TX log byte budget) and txRawCapacity are rounded up to a power of 2.
+			// lineCapacity caps the number of TX lines kept, txCapacity their total text size.
+			// txRawCapacity sizes the raw TX channel, 0 disables it.
 			ArduinoSerialPort(uint8_t portId,
-				size_t lineCapacity = 1024)
+				size_t lineCapacity = 1024,
+				size_t rxCapacity = DefaultRxCapacity,
+				size_t txCapacity = DefaultTxCapacity,
+				size_t txRawCapacity = DefaultTxRawCapacity)
 				: PortId(portId)
-				, LineCapacity(lineCapacity)
-				, m_lines(lineCapacity)
+				, m_txLog(lineCapacity, txCapacity)
+				, m_rxRing(rxCapacity)
+				, m_txRawRing(txRawCapacity > 0 ? new SpscByteRing(txRawCapacity) : nullptr)
 			{
+				m_txRaw.store(m_txRawRing.get(), std::memory_order_release);
 			}
 
 			uint32_t ElapsedTx() const
 			{
-				return GetTimestamp() - LastTx;
+				return GetTimestamp() - LastTx.load(std::memory_order_relaxed);
 			}
 
 			uint32_t ElapsedRx() const
 			{
-				return GetTimestamp() - LastRx;
+				return GetTimestamp() - LastRx.load(std::memory_order_relaxed);
+			}
+
+			uint8_t GetPortId() const
+			{
+				return PortId;
+			}
+
+			// Stamps TX lines and RX notifications with iteration, whatever thread writes. Set before the port is used.
+			void SetIterationSource(const std::atomic<uint32_t>& iteration)
+			{
+				m_iteration = &iteration;
+			}
+
+			// Completed loop() passes of the owning board's host, 0 for a standalone port.
+			uint32_t GetIteration() const
+			{
+				return m_iteration != nullptr ? m_iteration->load(std::memory_order_relaxed) : 0;
 			}
 
 			uint32_t GetRxId() const
 			{
-				return RxId;
+				return RxId.load(std::memory_order_acquire);
 			}
 
 			uint32_t GetTxId() const
 			{
-				return TxId;
+				return TxId.load(std::memory_order_acquire);
 			}
 
 			explicit operator bool() const noexcept
@@ -84,307 +188,578 @@ namespace ArduinoWindowsHost
 			}
 
 			// Call when the virtual port becomes usable.
+			// baudRate only takes effect with a timing model (see SetTiming()).
 			void begin(uint32_t baudRate = 0)
 			{
+				m_timing.SetBaudRate(baudRate);
 				m_ready.store(true, std::memory_order_release);
 			}
 
 			// Call to mark it unavailable.
+			// Releases any Rx() producer blocked on backpressure.
 			void end()
 			{
 				m_ready.store(false, std::memory_order_release);
+				if (m_rxWaiting.load(std::memory_order_acquire))
+				{
+					std::lock_guard<std::mutex> lk(m_rxProducerMutex);
+					m_rxSpaceCv.notify_all();
+				}
 			}
 
 
 			// --- Arduino-style RX API additions ---
+			// Consumer side of the RX ring: call from the sketch (loop) thread only.
 
 			// Number of bytes available to read.
-			size_t available() const
+			int available() final
 			{
-				std::lock_guard<std::mutex> lk(m_mutex);
-				return m_rxCount;
+				return static_cast<int>(m_rxRing.available());
 			}
 
 			// Peek next byte without removing; returns -1 if none.
-			int peek() const
+			int peek() final
 			{
-				std::lock_guard<std::mutex> lk(m_mutex);
-				if (m_rxCount == 0) return -1;
-				return static_cast<unsigned char>(m_rxBuffer[m_rxTail]);
+				return m_rxRing.peek();
 			}
 
 			// Read next byte; returns -1 if none.
-			int read()
+			int read() final
 			{
-				std::lock_guard<std::mutex> lk(m_mutex);
-				if (m_rxCount == 0) return -1;
-				char c = m_rxBuffer[m_rxTail];
-				m_rxTail = (m_rxTail + 1) % RxBufferCapacity;
-				--m_rxCount;
-				return static_cast<unsigned char>(c);
+				const int value = m_rxRing.read();
+				OnRxRead();
+				return value;
 			}
 
 			// Clear RX buffer only.
 			void flushRx()
 			{
-				std::lock_guard<std::mutex> lk(m_mutex);
-				m_rxHead = m_rxTail = m_rxCount = 0;
+				m_rxRing.clear();
+				if (m_rxWaiting.load(std::memory_order_relaxed))
+					OnRxSpace();
 			}
 
 			// Arduino's modern flush() waits for outgoing data. We have no
 			// async TX queue, so we repurpose to clear RX (legacy behavior).
-			void flush()
+			// Also commits the calling thread's buffered TX text.
+			void flush() final
 			{
+				flushTxBuffer();
+				m_timing.Drain();
 				flushRx();
 			}
 
+			// Free TX FIFO space with a timing model, else the FIFO never fills.
+			int availableForWrite() final
+			{
+				return static_cast<int>(m_timing.AvailableForWrite());
+			}
+
+			// --- Arduino Stream API ---
+			// Bulk reads copy straight out of the RX ring, one span at a time.
+			// Parsing and string reads are inherited from Stream.
+			using Stream::readBytes;
+			using Stream::readBytesUntil;
+
+			// Reads length bytes into buffer, returns bytes read (less on timeout).
+			size_t readBytes(uint8_t* buffer, const size_t length) final
+			{
+				size_t count = 0;
+				while (count < length)
+				{
+					const size_t chunk = m_rxRing.read(buffer + count, length - count);
+					if (chunk > 0)
+					{
+						count += chunk;
+						OnRxRead();
+					}
+					else if (!waitAvailable(getTimeout()))
+					{
+						break;
+					}
+				}
+				return count;
+			}
+
+			// As readBytes(), but also stops at terminator, which is consumed and not stored.
+			size_t readBytesUntil(const char terminator, uint8_t* buffer, const size_t length) final
+			{
+				size_t count = 0;
+				while (count < length)
+				{
+					bool terminated = false;
+					count += m_rxRing.readUntil(static_cast<uint8_t>(terminator), buffer + count, length - count, terminated);
+					OnRxRead();
+					if (terminated || (count < length && !waitAvailable(getTimeout())))
+						break;
+				}
+				return count;
+			}
+
+			// Zero-copy RX access: all readable bytes as two spans, the second after the ring wraps around.
+			// The reader may modify them in place (e.g. to decode frames) until consumeRx(). Returns the total length.
+			size_t peekRx(uint8_t*& first, size_t& firstLength, uint8_t*& second, size_t& secondLength)
+			{
+				return m_rxRing.peekSpans(first, firstLength, second, secondLength);
+			}
+
+			// Releases count RX bytes after peekRx().
+			void consumeRx(const size_t count)
+			{
+				m_rxRing.consume(count);
+				OnRxRead();
+			}
+
 			// Return buffered lines in chronological order (oldest first).
 			std::vector<std::string> getBufferedLines() const
 			{
 				std::lock_guard<std::mutex> lk(m_mutex);
 				std::vector<std::string> out;
-				out.reserve(m_count);
-				size_t start = (m_head + LineCapacity - m_count) % LineCapacity;
-				for (size_t i = 0; i < m_count; ++i)
-				{
-					out.push_back(m_lines[(start + i) % LineCapacity]);
-				}
+				out.reserve(m_txLog.size());
+				m_txLog.forEach([&out](const char* data, const size_t length)
+					{
+						out.emplace_back(data, length);
+					});
 				return out;
 			}
 
-			// Clear stored output lines and current assembling line.
-			void flushTx()
+			// Maximum number of TX lines kept.
+			size_t GetTxLineCapacity() const
+			{
+				return m_txLog.lineCapacity();
+			}
+
+			// Cursor positioned after the newest completed line, i.e. only lines printed from now on.
+			uint64_t GetTxCursor() const
 			{
 				std::lock_guard<std::mutex> lk(m_mutex);
-				std::fill(m_lines.begin(), m_lines.end(), std::string());
-				m_head = 0;
-				m_count = 0;
-				m_currentLine.clear();
+				return m_txLog.nextSequence();
+			}
 
-				TxId++;
+			// Cursor positioned at the oldest buffered line.
+			uint64_t GetTxOldestCursor() const
+			{
+				std::lock_guard<std::mutex> lk(m_mutex);
+				return m_txLog.oldestSequence();
 			}
 
-			// Number of stored lines currently in buffer.
-			size_t size() const
+			/// <summary>
+			/// Zero-copy incremental read: visits completed lines from cursor onward (oldest first)
+			/// as visitor(uint64_t sequence, const char* data, size_t length).
+			/// The visitor runs under the port lock: don't keep the pointers or call back into the port.
+			/// </summary>
+			/// <param name="cursor">Sequence of the first line wanted, the Next of a previous read.</param>
+			/// <param name="maxLines">Limit per call, to bound time spent holding the lock.</param>
+			template<typename F>
+			SerialTxCursor visitLinesFrom(const uint64_t cursor, F&& visitor, const size_t maxLines = SIZE_MAX) const
 			{
+				return visitTimedLinesFrom(cursor, [&visitor](const SerialTxLineInfo& info, const char* data, const size_t length)
+					{
+						visitor(info.Sequence, data, length);
+					}, maxLines);
+			}
+
+			// As visitLinesFrom(), with line metadata: visitor(const SerialTxLineInfo& info, const char* data, size_t length).
+			template<typename F>
+			SerialTxCursor visitTimedLinesFrom(const uint64_t cursor, F&& visitor, const size_t maxLines = SIZE_MAX) const
+			{
+				SerialTxCursor result{};
 				std::lock_guard<std::mutex> lk(m_mutex);
-				return m_count;
+				const uint64_t oldest = m_txLog.oldestSequence();
+				const uint64_t newest = m_txLog.nextSequence();
+				const uint64_t from = cursor < oldest ? oldest : (cursor > newest ? newest : cursor);
+				result.Next = m_txLog.forEachInfoFrom(cursor, std::forward<F>(visitor), result.Missed, maxLines);
+				result.Lines = static_cast<size_t>(result.Next - from);
+				return result;
 			}
 
-			// --- Print API (Arduino-like) ---
-			// Behavior:
-			// - print(...) appends to the current line buffer.
-			// - println(...) appends (if any) and then finalizes the line, pushing it into the circular buffer.
+			// Copying variant of visitLinesFrom(): appends lines from cursor onward to out.
+			SerialTxCursor getLinesFrom(const uint64_t cursor, std::vector<std::string>& out, const size_t maxLines = SIZE_MAX) const
+			{
+				return visitLinesFrom(cursor, [&out](const uint64_t, const char* data, const size_t length)
+					{
+						out.emplace_back(data, length);
+					}, maxLines);
+			}
 
-			void print(const char value)
+			// Copying variant of visitTimedLinesFrom(): appends lines from cursor onward, with metadata, to out.
+			SerialTxCursor getLinesFrom(const uint64_t cursor, std::vector<SerialTxLine>& out, const size_t maxLines = SIZE_MAX) const
 			{
-				OnTx();
+				return visitTimedLinesFrom(cursor, [&out](const SerialTxLineInfo& info, const char* data, const size_t length)
+					{
+						out.push_back(SerialTxLine{ info, std::string(data, length) });
+					}, maxLines);
+			}
 
-				std::lock_guard<std::mutex> lk(m_mutex);
-				m_currentLine.push_back(value);
+			// Monotonic clock of TX line timestamps, in nanoseconds.
+			static uint64_t GetTxClock()
+			{
+				using namespace std::chrono;
 
+				return static_cast<uint64_t>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
 			}
 
-			void println(const char value)
+			// Clear stored output lines and current assembling line.
+			void flushTx()
 			{
-				OnTx();
-				std::lock_guard<std::mutex> lk(m_mutex);
-				m_currentLine.push_back(value);
-				pushLineLocked(std::move(m_currentLine));
-				m_currentLine.clear();
+				if (IsTxBufferOwner())
+					m_txBufferLength = 0;
 
+				{
+					std::lock_guard<std::mutex> lk(m_mutex);
+					m_txLog.clear();
+					m_publishedSequence = m_txLog.nextSequence();
+
+					ForEachListener([this](ISerialListener& listener)
+						{
+							listener.OnSerialTxFlush(PortId);
+						});
+				}
+
+				TxId.fetch_add(1);
+				NotifyWaiters();
 			}
 
-			void print(const char* value)
+			// --- Notification API ---
+
+			// Blocks until the TX state id differs from sinceId (see GetTxId()) or the timeout expires.
+			// Returns true if TX changed.
+			bool waitForTx(const uint32_t sinceId, const uint32_t timeoutMillis) const
 			{
-				if (value == nullptr) return;
-				OnTx();
-				std::lock_guard<std::mutex> lk(m_mutex);
-				m_currentLine.append(value);
+				return WaitForChange(TxId, sinceId, timeoutMillis);
+			}
 
+			// Blocks until the RX state id differs from sinceId (see GetRxId()) or the timeout expires.
+			// Returns true if RX changed.
+			bool waitForRx(const uint32_t sinceId, const uint32_t timeoutMillis) const
+			{
+				return WaitForChange(RxId, sinceId, timeoutMillis);
 			}
 
-			void println(const char* value)
+			// Subscribes listener to line completion, raw TX and RX data. Returns false if all slots are taken.
+			bool addListener(ISerialListener& listener)
 			{
-				OnTx();
-				std::lock_guard<std::mutex> lk(m_mutex);
-				if (value != nullptr) m_currentLine.append(value);
-				pushLineLocked(std::move(m_currentLine));
-				m_currentLine.clear();
+				for (uint8_t i = 0; i < MaxListeners; i++)
+				{
+					ISerialListener* expected = nullptr;
+					if (m_listeners[i].compare_exchange_strong(expected, &listener))
+					{
+						m_listenerCount.fetch_add(1);
+						return true;
+					}
+				}
+				return false;
 			}
 
-			void print(const uint8_t value)
+			// Unsubscribes listener, returning once no callback to it is running.
+			// Must not be called from within a listener callback.
+			void removeListener(ISerialListener& listener)
 			{
-				OnTx();
-				std::lock_guard<std::mutex> lk(m_mutex);
-				m_currentLine.append(std::to_string(static_cast<unsigned int>(value)));
+				for (uint8_t i = 0; i < MaxListeners; i++)
+				{
+					ISerialListener* expected = &listener;
+					if (m_listeners[i].compare_exchange_strong(expected, nullptr))
+					{
+						m_listenerCount.fetch_sub(1);
+					}
+				}
+
+				while (m_listenerCalls.load() != 0)
+				{
+					std::this_thread::yield();
+				}
 			}
 
-			void println(const uint8_t value)
+			// Number of stored lines currently in buffer.
+			size_t size() const
 			{
-				OnTx();
 				std::lock_guard<std::mutex> lk(m_mutex);
-				m_currentLine.append(std::to_string(static_cast<unsigned int>(value)));
-				pushLineLocked(std::move(m_currentLine));
-				m_currentLine.clear();
+				return m_txLog.size();
 			}
 
-			void print(const int8_t value)
+			/// <summary>
+			/// Enables buffered TX for the calling thread: its print() fragments collect in a private buffer,
+			/// and the port is locked (and TxId bumped) once per write that completes a line, or on flushTxBuffer().
+			/// Other threads (e.g. timer ISRs) keep writing straight to the log, so their lines never land inside a buffered partial line.
+			/// Call from the printing thread, while no other thread prints buffered.
+			/// Rebinding or disabling commits the previous owner's pending text.
+			/// </summary>
+			/// <param name="capacity">Partial line bytes held before they are committed early.</param>
+			void SetTxBuffered(const bool enabled, const size_t capacity = DefaultTxBufferCapacity)
 			{
-				OnTx();
-				std::lock_guard<std::mutex> lk(m_mutex);
-				m_currentLine.append(std::to_string(static_cast<int>(value)));
+				if (m_txBufferLength > 0)
+				{
+					TxScope tx(*this);
+					appendLocked(m_txBuffer.get(), m_txBufferLength);
+					m_txBufferLength = 0;
+				}
+
+				if (enabled)
+				{
+					const size_t bufferCapacity = capacity > 0 ? capacity : 1;
+					if (bufferCapacity != m_txBufferCapacity)
+					{
+						m_txBuffer.reset(new char[bufferCapacity]);
+						m_txBufferCapacity = bufferCapacity;
+					}
+					m_txBufferOwner.store(std::this_thread::get_id(), std::memory_order_release);
+				}
+				else
+				{
+					m_txBufferOwner.store(std::thread::id(), std::memory_order_release);
+				}
 			}
 
-			void println(const int8_t value)
+			bool IsTxBuffered() const
 			{
-				OnTx();
-				std::lock_guard<std::mutex> lk(m_mutex);
-				m_currentLine.append(std::to_string(static_cast<int>(value)));
-				pushLineLocked(std::move(m_currentLine));
-				m_currentLine.clear();
+				return m_txBufferOwner.load(std::memory_order_acquire) != std::thread::id();
 			}
 
-			void print(const uint16_t value)
+			// Commits text buffered by the calling thread. No-op on other threads.
+			void flushTxBuffer()
 			{
-				OnTx();
-				std::lock_guard<std::mutex> lk(m_mutex);
-				m_currentLine.append(std::to_string(value));
+				if (IsTxBufferOwner() && m_txBufferLength > 0)
+				{
+					TxScope tx(*this);
+					appendLocked(m_txBuffer.get(), m_txBufferLength);
+					m_txBufferLength = 0;
+				}
 			}
 
-			void println(const uint16_t value)
+			// --- Print sink ---
+			// All print()/println() overloads are inherited from Print and end here, one lock per call.
+			// Text is appended to the open line; '\n' completes it and '\r' is dropped, so println()'s "\r\n" ends a line.
+			using Print::write;
+
+			size_t write(const uint8_t value) final
 			{
-				OnTx();
-				std::lock_guard<std::mutex> lk(m_mutex);
-				m_currentLine.append(std::to_string(value));
-				pushLineLocked(std::move(m_currentLine));
-				m_currentLine.clear();
+				return write(&value, 1);
+			}
+
+			size_t write(const uint8_t* buffer, const size_t size) final
+			{
+				if (buffer == nullptr || size == 0)
+					return 0;
+
+				if (m_timing.IsActive())
+					m_timing.Transmit(size);
+
+				// The raw channel is only signalled here when the line log path won't.
+				const bool raw = writeRaw(buffer, size);
+				if (!m_txLineLog.load(std::memory_order_relaxed))
+				{
+					if (raw)
+						OnTx();
+					return size;
+				}
+
+				if (IsTxBufferOwner())
+				{
+					if (raw)
+						OnTx();
+					return writeBuffered(reinterpret_cast<const char*>(buffer), size);
+				}
 
+				TxScope tx(*this);
+				appendLocked(reinterpret_cast<const char*>(buffer), size);
+				return size;
 			}
 
-			void print(const int16_t value)
+		public:
+			// Enables/disables logging written text as lines. The raw TX channel is unaffected.
+			void SetTxLineLog(const bool enabled)
 			{
-				OnTx();
-				std::lock_guard<std::mutex> lk(m_mutex);
-				m_currentLine.append(std::to_string(static_cast<int>(value)));
+				flushTxBuffer();
+				m_txLineLog.store(enabled, std::memory_order_relaxed);
+			}
+
+			// --- Raw TX channel ---
+			// Every written byte, in order and unmodified (NUL, '\r' and '\n' included), next to the line log.
+			// Consumer calls are for a single reader thread (recorder, bridge); use waitForTx() to block for data.
+			// When the reader falls behind, new bytes are dropped and counted rather than blocking the sketch.
 
+			// Raw channel size in bytes, 0 when disabled.
+			size_t GetTxRawCapacity() const
+			{
+				const SpscByteRing* raw = m_txRaw.load(std::memory_order_acquire);
+				return raw ? raw->capacity() : 0;
 			}
 
-			void println(const int16_t value)
+			/// <summary>
+			/// Turns the raw channel on for a consumer (bridge, runner), if the port was built without one.
+			/// Bytes written before are not in it. Stays on for the port's lifetime.
+			/// </summary>
+			/// <param name="capacity">Channel size, rounded up to a power of 2. Ignored if already enabled.</param>
+			void EnableTxRaw(const size_t capacity = DefaultEnabledTxRawCapacity)
 			{
-				OnTx();
-				std::lock_guard<std::mutex> lk(m_mutex);
-				m_currentLine.append(std::to_string(static_cast<int>(value)));
-				pushLineLocked(std::move(m_currentLine));
-				m_currentLine.clear();
+				std::lock_guard<std::mutex> lk(m_txRawMutex);
+				if (m_txRawRing || capacity == 0)
+					return;
+				m_txRawRing.reset(new SpscByteRing(capacity));
+				m_txRaw.store(m_txRawRing.get(), std::memory_order_release);
+			}
 
+			// Bytes dropped because the raw channel was full.
+			uint32_t GetTxRawDropped() const
+			{
+				return TxRawDropped.load(std::memory_order_relaxed);
 			}
 
-			void print(const uint32_t value)
+			// Raw bytes ready to read.
+			size_t availableTxRaw() const
 			{
-				OnTx();
-				std::lock_guard<std::mutex> lk(m_mutex);
-				m_currentLine.append(std::to_string(value));
+				const SpscByteRing* raw = m_txRaw.load(std::memory_order_acquire);
+				return raw ? raw->available() : 0;
 			}
 
-			void println(const uint32_t value)
+			// Zero-copy access to the next contiguous span of raw bytes, returns its length (0 if none).
+			// The span stays valid until consumeTxRaw().
+			size_t peekTxRaw(const uint8_t*& data) const
 			{
-				OnTx();
-				std::lock_guard<std::mutex> lk(m_mutex);
-				m_currentLine.append(std::to_string(value));
-				pushLineLocked(std::move(m_currentLine));
-				m_currentLine.clear();
+				const SpscByteRing* raw = m_txRaw.load(std::memory_order_acquire);
+				if (!raw)
+				{
+					data = nullptr;
+					return 0;
+				}
+				return raw->peekSpan(data);
 			}
 
-			void print(const int32_t value)
+			// Releases count raw bytes, after peekTxRaw().
+			void consumeTxRaw(const size_t count)
 			{
-				OnTx();
-				std::lock_guard<std::mutex> lk(m_mutex);
-				m_currentLine.append(std::to_string(value));
+				SpscByteRing* raw = m_txRaw.load(std::memory_order_acquire);
+				if (raw)
+					raw->consume(count);
 			}
 
-			void println(const int32_t value)
+			/// <summary>
+			/// Visits readable raw bytes in place as visitor(const uint8_t* data, size_t length), consuming them.
+			/// A wrapped ring is visited as two spans.
+			/// </summary>
+			/// <returns>Bytes visited.</returns>
+			template<typename F>
+			size_t drainTxRaw(F&& visitor, const size_t maxBytes = SIZE_MAX)
 			{
-				OnTx();
-				std::lock_guard<std::mutex> lk(m_mutex);
-				m_currentLine.append(std::to_string(value));
-				pushLineLocked(std::move(m_currentLine));
-				m_currentLine.clear();
+				size_t total = 0;
+				const uint8_t* data;
+				size_t length;
+				while (total < maxBytes && (length = peekTxRaw(data)) > 0)
+				{
+					if (length > maxBytes - total)
+						length = maxBytes - total;
+					visitor(data, length);
+					m_txRaw.load(std::memory_order_relaxed)->consume(length);
+					total += length;
+				}
+				return total;
 			}
 
-			void println()
+			// Copying read of raw bytes, returns bytes read.
+			size_t readTxRaw(uint8_t* buffer, const size_t length)
 			{
-				OnTx();
-				std::lock_guard<std::mutex> lk(m_mutex);
-				pushLineLocked(std::move(m_currentLine));
-				m_currentLine.clear();
+				SpscByteRing* raw = m_txRaw.load(std::memory_order_acquire);
+				return raw ? raw->read(buffer, length) : 0;
 			}
 
-			// std::string
-			void print(const std::string& value)
+		public:
+			// RX ring size in bytes.
+			size_t GetRxCapacity() const
 			{
-				OnTx();
-				std::lock_guard<std::mutex> lk(m_mutex);
-				m_currentLine.append(value);
+				return m_rxRing.capacity();
 			}
 
-			void println(const std::string& value)
+			// Bytes Rx() can accept right now. Producer side, safe from bridge threads (unlike available()).
+			size_t GetRxFree()
 			{
-				OnTx();
-				std::lock_guard<std::mutex> lk(m_mutex);
-				m_currentLine.append(value);
-				pushLineLocked(std::move(m_currentLine));
-				m_currentLine.clear();
+				std::lock_guard<std::mutex> lk(m_rxProducerMutex);
+				return m_rxRing.freeSpace();
 			}
 
-			// C-string with explicit length (may contain nulls)
-			void print(const char* value, size_t length)
+			// Bytes rejected by Rx() because the RX ring was full.
+			uint32_t GetRxDropped() const
 			{
-				if (!value || length == 0) return;
-				OnTx();
-				std::lock_guard<std::mutex> lk(m_mutex);
-				m_currentLine.append(value, length);
+				return RxDropped.load(std::memory_order_relaxed);
 			}
 
-			void println(const char* value, size_t length)
+			// Rx() calls that could not be fully accepted.
+			uint32_t GetRxOverflows() const
 			{
-				OnTx();
-				std::lock_guard<std::mutex> lk(m_mutex);
-				if (value && length)
-					m_currentLine.append(value, length);
-				pushLineLocked(std::move(m_currentLine));
-				m_currentLine.clear();
+				return RxOverflows.load(std::memory_order_relaxed);
 			}
 
-			void print(const __FlashStringHelper* value)
+			/// <summary>
+			/// Enables RX backpressure: Rx() blocks while the ring is full, resuming as the sketch reads,
+			/// until all bytes are accepted, the timeout expires or the port is end()ed.
+			/// Disabled (default): bytes that don't fit are dropped and counted.
+			/// </summary>
+			/// <param name="timeoutMillis">Maximum time a single Rx() call may block.</param>
+			void SetRxBackpressure(const bool enabled, const uint32_t timeoutMillis = UINT32_MAX)
 			{
-				if (!value) return;
-				OnTx();
-				std::lock_guard<std::mutex> lk(m_mutex);
-				m_currentLine.append(reinterpret_cast<const char*>(value));
+				std::lock_guard<std::mutex> lk(m_rxProducerMutex);
+				m_rxBackpressure = enabled;
+				m_rxBackpressureTimeout = timeoutMillis;
 			}
 
-			void println(const __FlashStringHelper* value)
+			/// <summary>
+			/// Counts terminator bytes as Rx() accepts them, so line-oriented readers can tell a line has completed
+			/// from GetRxTerminators() alone, without scanning the ring. Pass -1 to stop counting (default).
+			/// </summary>
+			void SetRxTerminator(const int terminator)
 			{
-				OnTx();
-				std::lock_guard<std::mutex> lk(m_mutex);
-				if (value)
-					m_currentLine.append(reinterpret_cast<const char*>(value));
-				pushLineLocked(std::move(m_currentLine));
-				m_currentLine.clear();
+				std::lock_guard<std::mutex> lk(m_rxProducerMutex);
+				m_rxTerminator.store(terminator < 0 ? -1 : static_cast<uint8_t>(terminator), std::memory_order_relaxed);
+			}
+
+			// Terminator being counted, -1 if none.
+			int GetRxTerminator() const
+			{
+				return m_rxTerminator.load(std::memory_order_relaxed);
+			}
+
+			// Terminators received so far, changes once per completed line.
+			uint32_t GetRxTerminators() const
+			{
+				return RxTerminators.load(std::memory_order_acquire);
+			}
+
+			/// <summary>
+			/// Baud rate timing model, off by default. With a mode set, begin(baudRate) meters the port like
+			/// HardwareSerial: writes fill a txFifo byte FIFO drained at the line rate, blocking while it's full
+			/// (Block) or only accounting the wait (Measure); in Block mode Rx() also delivers at the line rate.
+			/// </summary>
+			/// <param name="frameBits">Bits per byte on the line, 10 for 8N1.</param>
+			void SetTiming(const SerialTiming mode, const size_t txFifo = SerialTimingModel::DefaultTxFifo, const uint8_t frameBits = SerialTimingModel::DefaultFrameBits)
+			{
+				m_timing.SetMode(mode, txFifo, frameBits);
+			}
+
+			SerialTiming GetTiming() const
+			{
+				return m_timing.GetMode();
+			}
+
+			uint32_t GetBaudRate() const
+			{
+				return m_timing.GetBaudRate();
+			}
+
+			// Bytes metered, and time writers spent blocked on the TX FIFO (or would have, in Measure mode).
+			SerialTimingModel::Statistics GetTimingStatistics() const
+			{
+				return m_timing.GetStatistics();
+			}
+
+			void ResetTimingStatistics()
+			{
+				m_timing.ResetStatistics();
 			}
 
 		public:
+			// Producer side of the RX ring: any thread, serialized by m_rxProducerMutex.
 			void Rx(const char value)
 			{
-				std::lock_guard<std::mutex> lk(m_mutex);
-				if (m_rxCount < RxBufferCapacity)
-				{
-					m_rxBuffer[m_rxHead] = value;
-					m_rxHead = (m_rxHead + 1) % RxBufferCapacity;
-					++m_rxCount;
-					OnRx();
-				}
+				Rx(&value, 1);
 			}
 
 			// Feed a null-terminated C string. Stops at first '\0'.
@@ -395,25 +770,29 @@ namespace ArduinoWindowsHost
 			}
 
 			// Feed a raw char buffer (may contain nulls). Returns number of bytes accepted.
+			// With Block timing, each slice (see GetRxSlice()) becomes readable once it has arrived over the line.
 			size_t Rx(const char* data, size_t length)
 			{
 				if (!data || length == 0) return 0;
-				std::lock_guard<std::mutex> lk(m_mutex);
+
+				const size_t slice = GetRxSlice();
+				if (length <= slice)
+					return RxSlice(data, length);
+
 				size_t accepted = 0;
-				while (accepted < length && m_rxCount < RxBufferCapacity)
-				{
-					m_rxBuffer[m_rxHead] = data[accepted];
-					m_rxHead = (m_rxHead + 1) % RxBufferCapacity;
-					++m_rxCount;
-					++accepted;
-				}
-				if (accepted)
-				{
-					OnRx(); // single state change for the whole batch
-				}
+				for (size_t offset = 0; offset < length; offset += slice)
+					accepted += RxSlice(data + offset, std::min(slice, length - offset));
 				return accepted;
 			}
 
+			// Largest Rx() chunk delivered at once: a FIFO's worth while Block timing meters RX, SIZE_MAX otherwise.
+			// Feeders sharing their thread with other work (bridges) pass at most this much per call,
+			// so Rx() holds them for no longer than a FIFO's line time.
+			size_t GetRxSlice() const
+			{
+				return m_timing.IsActive() ? m_timing.GetRxSlice() : SIZE_MAX;
+			}
+
 			// Feed a raw unsigned byte buffer.
 			size_t Rx(const uint8_t* data, size_t length)
 			{
@@ -439,38 +818,338 @@ namespace ArduinoWindowsHost
 			}
 
 		private:
-			// push a complete line into the circular buffer (oldest overwritten when full)
-			void pushLineLocked(std::string&& line)
+			// Meters (see SetTiming()) and feeds one slice.
+			size_t RxSlice(const char* data, const size_t length)
 			{
-				// assumes m_mutex is held
-				m_lines[m_head] = std::move(line);
-				m_head = (m_head + 1) % LineCapacity;
-				if (m_count < LineCapacity) ++m_count;
+				if (m_timing.IsActive())
+					m_timing.Receive(length);
+
+				size_t accepted;
+				{
+					std::unique_lock<std::mutex> lk(m_rxProducerMutex);
+					accepted = m_rxRing.write(reinterpret_cast<const uint8_t*>(data), length);
+					PublishRxLocked(reinterpret_cast<const uint8_t*>(data), accepted);
+
+					if (accepted < length && m_rxBackpressure)
+					{
+						accepted += RxBlockingLocked(lk, reinterpret_cast<const uint8_t*>(data) + accepted, length - accepted);
+					}
+				}
+
+				if (accepted < length)
+				{
+					RxDropped.fetch_add(static_cast<uint32_t>(length - accepted), std::memory_order_relaxed);
+					RxOverflows.fetch_add(1, std::memory_order_relaxed);
+				}
+
+				if (accepted)
+				{
+					OnRx(); // single state change for the whole batch
+				}
+				return accepted;
+			}
+
+			// Append text to the open TX line, splitting lines on '\n', assumes m_mutex is held.
+			// Completed lines are stamped with one clock read per call.
+			void appendLocked(const char* text, const size_t length)
+			{
+				uint64_t timestamp = 0;
+				size_t start = 0;
+				for (size_t i = 0; i < length; i++)
+				{
+					const char c = text[i];
+					if (c == '\n' || c == '\r')
+					{
+						if (i > start)
+							m_txLog.append(text + start, i - start);
+						if (c == '\n')
+						{
+							if (timestamp == 0)
+								timestamp = GetTxClock();
+							m_txLog.commit(timestamp, GetIteration());
+						}
+						start = i + 1;
+					}
+				}
+
+				if (length > start)
+					m_txLog.append(text + start, length - start);
+			}
+
+			// Copies to the raw TX channel, returns false when disabled.
+			bool writeRaw(const uint8_t* buffer, const size_t size)
+			{
+				SpscByteRing* raw = m_txRaw.load(std::memory_order_acquire);
+				if (!raw)
+					return false;
+
+				size_t accepted;
+				{
+					std::lock_guard<std::mutex> lk(m_txRawMutex);
+					accepted = raw->write(buffer, size);
+					PublishTxRawLocked(buffer, accepted);
+				}
+				if (accepted < size)
+					TxRawDropped.fetch_add(static_cast<uint32_t>(size - accepted), std::memory_order_relaxed);
+
+				return true;
+			}
+
+			// Buffered write, owner thread only: lock only when a line completes or the buffer overflows.
+			size_t writeBuffered(const char* text, const size_t length)
+			{
+				// Everything up to and including the last '\n' goes to the log.
+				size_t complete = length;
+				while (complete > 0 && text[complete - 1] != '\n')
+					complete--;
+
+				size_t rest = length - complete;
+				if (complete == 0 && m_txBufferLength + rest <= m_txBufferCapacity)
+				{
+					memcpy(m_txBuffer.get() + m_txBufferLength, text, rest);
+					m_txBufferLength += rest;
+					return length;
+				}
+
+				{
+					TxScope tx(*this);
+					appendLocked(m_txBuffer.get(), m_txBufferLength);
+					m_txBufferLength = 0;
+					appendLocked(text, complete);
+
+					if (rest > m_txBufferCapacity)
+					{
+						appendLocked(text + complete, rest);
+						rest = 0;
+					}
+				}
+
+				memcpy(m_txBuffer.get(), text + complete, rest);
+				m_txBufferLength = rest;
+
+				return length;
 			}
 
-			// Iterate over buffered lines (oldest first).
+			bool IsTxBufferOwner() const
+			{
+				return m_txBufferOwner.load(std::memory_order_relaxed) == std::this_thread::get_id();
+			}
+
+			// Iterate over buffered lines (oldest first), as f(const char* data, size_t length).
 			template <typename F>
 			void for_each_buffered_line(F&& f) const
 			{
 				std::lock_guard<std::mutex> lk(m_mutex);
-				size_t start = (m_head + LineCapacity - m_count) % LineCapacity;
-				for (size_t i = 0; i < m_count; ++i)
+				m_txLog.forEach(std::forward<F>(f));
+			}
+
+			// Backpressure wait loop, m_rxProducerMutex held by lk.
+			size_t RxBlockingLocked(std::unique_lock<std::mutex>& lk, const uint8_t* data, const size_t length)
+			{
+				using namespace std::chrono;
+
+				// Bounded wait slices guard against a missed wake-up, as the consumer checks m_rxWaiting without a fence.
+				static constexpr uint32_t WaitSliceMicros = 1000;
+
+				const steady_clock::time_point start = steady_clock::now();
+				size_t accepted = 0;
+
+				m_rxWaiting.store(true, std::memory_order_seq_cst);
+				while (accepted < length && m_ready.load(std::memory_order_acquire))
 				{
-					f(m_lines[(start + i) % LineCapacity]);
+					if (m_rxBackpressureTimeout != UINT32_MAX
+						&& steady_clock::now() - start >= milliseconds(m_rxBackpressureTimeout))
+						break;
+
+					m_rxSpaceCv.wait_for(lk, microseconds(WaitSliceMicros));
+
+					const size_t written = m_rxRing.write(data + accepted, length - accepted);
+					PublishRxLocked(data + accepted, written);
+					if (written)
+					{
+						accepted += written;
+						OnRx(); // Let the sketch see partial progress.
+					}
+				}
+				m_rxWaiting.store(false, std::memory_order_relaxed);
+
+				return accepted;
+			}
+
+			// Call after consuming RX bytes.
+			void OnRxRead()
+			{
+				if (m_rxWaiting.load(std::memory_order_relaxed))
+					OnRxSpace();
+			}
+
+		protected:
+			// Blocks on RX notifications for up to timeoutMillis. Returns false on timeout.
+			bool waitAvailable(const uint32_t timeoutMillis) final
+			{
+				const uint32_t start = GetTimestamp();
+				const uint64_t timeoutMicros = static_cast<uint64_t>(timeoutMillis) * 1000;
+				while (true)
+				{
+					const uint32_t rxId = GetRxId();
+					if (m_rxRing.available() > 0)
+						return true;
+
+					const uint64_t elapsed = GetTimestamp() - start;
+					if (elapsed >= timeoutMicros
+						|| !waitForRx(rxId, static_cast<uint32_t>((timeoutMicros - elapsed + 999) / 1000)))
+						return false;
+				}
+			}
+
+		private:
+			// Consumer freed RX space while a producer waits: wake it once half the ring is free.
+			void OnRxSpace()
+			{
+				if (m_rxRing.available() <= (m_rxRing.capacity() / 2))
+				{
+					std::lock_guard<std::mutex> lk(m_rxProducerMutex);
+					m_rxSpaceCv.notify_all();
 				}
 			}
 
 		private:
+			// Holds the TX lock for one print call.
+			// On exit publishes completed lines to listeners, then bumps TxId and wakes waiters.
+			class TxScope
+			{
+			private:
+				ArduinoSerialPort& Port;
+				std::unique_lock<std::mutex> Lock;
+
+			public:
+				TxScope(ArduinoSerialPort& port)
+					: Port(port)
+					, Lock(port.m_mutex)
+				{
+				}
+
+				~TxScope()
+				{
+					Port.PublishTxLocked();
+					Lock.unlock();
+					Port.OnTx();
+				}
+			};
+
+			// Hands lines completed since the last call to listeners, assumes m_mutex is held.
+			void PublishTxLocked()
+			{
+				const uint64_t next = m_txLog.nextSequence();
+				if (next == m_publishedSequence)
+					return;
+
+				if (m_listenerCount.load(std::memory_order_relaxed) > 0)
+				{
+					bool missed;
+					m_txLog.forEachInfoFrom(m_publishedSequence, [this](const SerialLineLog::LineInfo& info, const char* data, const size_t length)
+						{
+							ForEachListener([this, &info, data, length](ISerialListener& listener)
+								{
+									listener.OnSerialTxLine(PortId, info, data, length);
+								});
+						}, missed);
+				}
+				m_publishedSequence = next;
+			}
+
+			// Hands accepted raw TX bytes to listeners, assumes m_txRawMutex is held.
+			void PublishTxRawLocked(const uint8_t* data, const size_t length)
+			{
+				if (length > 0 && m_listenerCount.load(std::memory_order_relaxed) > 0)
+				{
+					ForEachListener([this, data, length](ISerialListener& listener)
+						{
+							listener.OnSerialTxRaw(PortId, data, length);
+						});
+				}
+			}
+
+			// Counts terminators in accepted RX bytes and hands them to listeners, assumes m_rxProducerMutex is held.
+			void PublishRxLocked(const uint8_t* data, const size_t length)
+			{
+				const int terminator = m_rxTerminator.load(std::memory_order_relaxed);
+				if (terminator >= 0 && length > 0)
+				{
+					uint32_t count = 0;
+					const uint8_t* from = data;
+					const uint8_t* end = data + length;
+					while (from < end && (from = static_cast<const uint8_t*>(memchr(from, terminator, static_cast<size_t>(end - from)))) != nullptr)
+					{
+						count++;
+						from++;
+					}
+					if (count > 0)
+						RxTerminators.fetch_add(count, std::memory_order_release);
+				}
+
+				if (length > 0 && m_listenerCount.load(std::memory_order_relaxed) > 0)
+				{
+					const uint32_t iteration = GetIteration();
+					ForEachListener([this, iteration, data, length](ISerialListener& listener)
+						{
+							listener.OnSerialRx(PortId, iteration, data, length);
+						});
+				}
+			}
+
+			template<typename F>
+			void ForEachListener(F&& f)
+			{
+				m_listenerCalls.fetch_add(1);
+				for (uint8_t i = 0; i < MaxListeners; i++)
+				{
+					ISerialListener* listener = m_listeners[i].load();
+					if (listener != nullptr)
+						f(*listener);
+				}
+				m_listenerCalls.fetch_sub(1);
+			}
+
+			bool WaitForChange(const std::atomic<uint32_t>& id, const uint32_t sinceId, const uint32_t timeoutMillis) const
+			{
+				if (id.load() != sinceId)
+					return true;
+
+				// Register before the final check, NotifyWaiters() runs after the id changes.
+				m_waiters.fetch_add(1);
+				bool changed;
+				{
+					std::unique_lock<std::mutex> lk(m_waitMutex);
+					changed = m_waitCv.wait_for(lk, std::chrono::milliseconds(timeoutMillis),
+						[&id, sinceId]() { return id.load() != sinceId; });
+				}
+				m_waiters.fetch_sub(1);
+
+				return changed;
+			}
+
+			void NotifyWaiters()
+			{
+				if (m_waiters.load() > 0)
+				{
+					std::lock_guard<std::mutex> lk(m_waitMutex);
+					m_waitCv.notify_all();
+				}
+			}
+
 			void OnTx()
 			{
-				LastTx = GetTimestamp();
-				TxId++;
+				LastTx.store(GetTimestamp(), std::memory_order_relaxed);
+				TxId.fetch_add(1);
+				NotifyWaiters();
 			}
 
 			void OnRx()
 			{
-				LastRx = GetTimestamp();
-				RxId++;
+				LastRx.store(GetTimestamp(), std::memory_order_relaxed);
+				RxId.fetch_add(1);
+				NotifyWaiters();
 			}
 
 			static uint32_t GetTimestamp()
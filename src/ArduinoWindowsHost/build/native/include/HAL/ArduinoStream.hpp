@@ -0,0 +1,310 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <string>
+#include <chrono>
+#include <thread>
+
+#include "ArduinoPrint.hpp"
+
+namespace ArduinoWindowsHost
+{
+	namespace Hal
+	{
+		// Arduino Stream parse lookahead modes.
+		enum LookaheadMode : uint8_t
+		{
+			SKIP_ALL,		// All invalid characters are ignored.
+			SKIP_NONE,		// Nothing is skipped, parsing stops at the first invalid character.
+			SKIP_WHITESPACE	// Only tabs, spaces, line feeds and carriage returns are skipped.
+		};
+
+		static constexpr char NO_IGNORE_CHAR = '\x01';
+
+		/// <summary>
+		/// Arduino Stream base: timed reads and parsing on top of available()/read()/peek().
+		/// - Timed reads wait up to the stream timeout for more data, restarting it on every byte or chunk received.
+		/// - readBytes()/readBytesUntil() are virtual so buffered sources can copy out in bulk;
+		///   readString()/readStringUntil() are built on them.
+		/// - waitAvailable() polls by default, sources with a wake-up signal override it.
+		/// </summary>
+		class Stream : public Print
+		{
+		private:
+			// Timeout for timed reads (ms).
+			uint32_t Timeout = 1000;
+
+		public:
+			virtual int available() = 0;
+			virtual int read() = 0;
+			virtual int peek() = 0;
+
+		public:
+			// Sets the maximum milliseconds to wait for stream data, default 1000.
+			void setTimeout(const uint32_t timeoutMillis)
+			{
+				Timeout = timeoutMillis;
+			}
+
+			uint32_t getTimeout() const
+			{
+				return Timeout;
+			}
+
+			// Reads until target is found, true if found before the timeout.
+			bool find(const char* target)
+			{
+				return findUntil(target, strlen(target), nullptr, 0);
+			}
+
+			bool find(const char* target, const size_t length)
+			{
+				return findUntil(target, length, nullptr, 0);
+			}
+
+			bool find(const char target)
+			{
+				return find(&target, 1);
+			}
+
+			// As find(), but also stops (returning false) when terminator is found.
+			bool findUntil(const char* target, const char* terminator)
+			{
+				return findUntil(target, strlen(target), terminator, terminator != nullptr ? strlen(terminator) : 0);
+			}
+
+			bool findUntil(const char* target, const size_t targetLength, const char* terminator, const size_t terminatorLength)
+			{
+				if (targetLength == 0)
+					return true;
+
+				size_t targetIndex = 0;
+				size_t terminatorIndex = 0;
+				int c;
+				while ((c = timedRead()) >= 0)
+				{
+					targetIndex = MatchNext(target, targetIndex, static_cast<char>(c));
+					if (targetIndex >= targetLength)
+						return true;
+
+					if (terminatorLength > 0)
+					{
+						terminatorIndex = MatchNext(terminator, terminatorIndex, static_cast<char>(c));
+						if (terminatorIndex >= terminatorLength)
+							return false;
+					}
+				}
+				return false;
+			}
+
+			// Reads length bytes into buffer, returns bytes read (less on timeout).
+			virtual size_t readBytes(uint8_t* buffer, const size_t length)
+			{
+				size_t count = 0;
+				while (count < length)
+				{
+					const int c = timedRead();
+					if (c < 0)
+						break;
+					buffer[count++] = static_cast<uint8_t>(c);
+				}
+				return count;
+			}
+
+			size_t readBytes(char* buffer, const size_t length)
+			{
+				return readBytes(reinterpret_cast<uint8_t*>(buffer), length);
+			}
+
+			// As readBytes(), but also stops at terminator, which is consumed and not stored.
+			virtual size_t readBytesUntil(const char terminator, uint8_t* buffer, const size_t length)
+			{
+				size_t count = 0;
+				while (count < length)
+				{
+					const int c = timedRead();
+					if (c < 0 || static_cast<char>(c) == terminator)
+						break;
+					buffer[count++] = static_cast<uint8_t>(c);
+				}
+				return count;
+			}
+
+			size_t readBytesUntil(const char terminator, char* buffer, const size_t length)
+			{
+				return readBytesUntil(terminator, reinterpret_cast<uint8_t*>(buffer), length);
+			}
+
+			// Reads into a string until the timeout expires.
+			std::string readString()
+			{
+				std::string value;
+				uint8_t chunk[64];
+				size_t count;
+				while ((count = readBytes(chunk, sizeof(chunk))) > 0)
+				{
+					value.append(reinterpret_cast<const char*>(chunk), count);
+					if (count < sizeof(chunk))
+						break;
+				}
+				return value;
+			}
+
+			// Reads into a string until terminator (consumed, not stored) or timeout.
+			std::string readStringUntil(const char terminator)
+			{
+				// A short chunk means terminated or timed out. A full chunk followed by the
+				// terminator yields an empty next chunk, which ends the loop as well.
+				std::string value;
+				uint8_t chunk[64];
+				size_t count;
+				while ((count = readBytesUntil(terminator, chunk, sizeof(chunk))) > 0)
+				{
+					value.append(reinterpret_cast<const char*>(chunk), count);
+					if (count < sizeof(chunk))
+						break;
+				}
+				return value;
+			}
+
+			// Returns the first valid integer from the current position, 0 on timeout.
+			// Characters matching ignore are skipped inside the number (e.g. thousands separators).
+			long parseInt(const LookaheadMode lookahead = SKIP_ALL, const char ignore = NO_IGNORE_CHAR)
+			{
+				bool isNegative = false;
+				long value = 0;
+
+				int c = peekNextDigit(lookahead, false);
+				if (c < 0)
+					return 0;
+
+				do
+				{
+					if (static_cast<char>(c) == ignore) {}
+					else if (c == '-') isNegative = true;
+					else if (c >= '0' && c <= '9') value = value * 10 + c - '0';
+					read();
+					c = timedPeek();
+				} while ((c >= '0' && c <= '9') || static_cast<char>(c) == ignore);
+
+				return isNegative ? -value : value;
+			}
+
+			long parseInt(const char ignore)
+			{
+				return parseInt(SKIP_ALL, ignore);
+			}
+
+			// Returns the first valid float from the current position, 0 on timeout.
+			float parseFloat(const LookaheadMode lookahead = SKIP_ALL, const char ignore = NO_IGNORE_CHAR)
+			{
+				bool isNegative = false;
+				bool isFraction = false;
+				double value = 0.0;
+				double fraction = 1.0;
+
+				int c = peekNextDigit(lookahead, true);
+				if (c < 0)
+					return 0;
+
+				do
+				{
+					if (static_cast<char>(c) == ignore) {}
+					else if (c == '-') isNegative = true;
+					else if (c == '.') isFraction = true;
+					else if (c >= '0' && c <= '9')
+					{
+						if (isFraction)
+						{
+							fraction *= 0.1;
+							value = value + fraction * (c - '0');
+						}
+						else
+						{
+							value = value * 10 + c - '0';
+						}
+					}
+					read();
+					c = timedPeek();
+				} while ((c >= '0' && c <= '9') || (c == '.' && !isFraction) || static_cast<char>(c) == ignore);
+
+				return static_cast<float>(isNegative ? -value : value);
+			}
+
+			float parseFloat(const char ignore)
+			{
+				return parseFloat(SKIP_ALL, ignore);
+			}
+
+		protected:
+			// Waits up to timeoutMillis for data to read. Returns false on timeout.
+			virtual bool waitAvailable(const uint32_t timeoutMillis)
+			{
+				using namespace std::chrono;
+
+				const steady_clock::time_point start = steady_clock::now();
+				while (available() <= 0)
+				{
+					if (steady_clock::now() - start >= milliseconds(timeoutMillis))
+						return false;
+					std::this_thread::yield();
+				}
+				return true;
+			}
+
+			int timedRead()
+			{
+				int c = read();
+				if (c < 0 && waitAvailable(Timeout))
+					c = read();
+				return c;
+			}
+
+			int timedPeek()
+			{
+				int c = peek();
+				if (c < 0 && waitAvailable(Timeout))
+					c = peek();
+				return c;
+			}
+
+			// Peeks the next numeric character, skipping others according to lookahead. -1 on timeout or stop.
+			int peekNextDigit(const LookaheadMode lookahead, const bool detectDecimal)
+			{
+				while (true)
+				{
+					const int c = timedPeek();
+
+					if (c < 0 || c == '-' || (c >= '0' && c <= '9') || (detectDecimal && c == '.'))
+						return c;
+
+					switch (lookahead)
+					{
+					case SKIP_NONE:
+						return -1;
+					case SKIP_WHITESPACE:
+						if (c != ' ' && c != '\t' && c != '\r' && c != '\n')
+							return -1;
+						break;
+					case SKIP_ALL:
+					default:
+						break;
+					}
+
+					read();
+				}
+			}
+
+		private:
+			// Advances a match of pattern by c, restarting on mismatch.
+			static size_t MatchNext(const char* pattern, const size_t index, const char c)
+			{
+				if (c == pattern[index])
+					return index + 1;
+				return c == pattern[0] ? 1 : 0;
+			}
+		};
+	}
+}
@@ -0,0 +1,353 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+#include "HalBinding.hpp"
+
+namespace ArduinoWindowsHost
+{
+	namespace Hal
+	{
+		// Emulated global interrupt mask, one per host (see HalContext).
+		// - Timer ISRs run while holding the lock, so they never overlap each other (single core).
+		// - noInterrupts()/interrupts() take/release the same lock from sketch code.
+		struct InterruptState
+		{
+			static std::recursive_mutex& Lock()
+			{
+				std::recursive_mutex* bound = HalBinding::Current().InterruptLock;
+				if (bound != nullptr)
+					return *bound;
+
+				static std::recursive_mutex lock{};
+				return lock;
+			}
+
+			// Per-thread flag so unbalanced interrupts() calls are harmless.
+			static bool& Disabled()
+			{
+				static thread_local bool disabled = false;
+				return disabled;
+			}
+		};
+
+		/// <summary>
+		/// TimerOne style periodic timer peripheral.
+		/// Fires the attached callback every period from a dedicated timing thread,
+		/// emulating a hardware timer ISR that preempts loop().
+		/// Timing: sleeps until close to the deadline, then spins for the remainder.
+		/// Periods below SpinThresholdMicros keep the timing thread spinning.
+		/// Tracks ISR latency (actual - scheduled start) and missed ticks.
+		/// </summary>
+		class ArduinoTimer
+		{
+		public:
+			// Below this distance to the deadline the thread spins instead of sleeping.
+			// OS sleep granularity is coarse (up to a few ms on Windows).
+			static constexpr uint32_t SpinThresholdMicros = 2000;
+
+			static constexpr uint32_t DefaultPeriodMicros = 1000000;
+
+			struct Statistics
+			{
+				uint32_t Count = 0;			// ISR invocations.
+				uint32_t Missed = 0;		// Ticks skipped because the ISR ran a full period late.
+				uint32_t LatencyMin = 0;	// Best case ISR start latency (us).
+				uint32_t LatencyMax = 0;	// Worst case ISR start latency (us).
+				uint32_t LatencyAverage = 0;// Mean ISR start latency (us).
+				uint32_t Jitter = 0;		// Peak-to-peak latency spread (us).
+			};
+
+		private:
+			using Clock = std::chrono::steady_clock;
+
+		private:
+			// Owner host's HAL state, bound on the timing thread so ISRs see the same context as loop().
+			const HalBinding Binding;
+
+			std::mutex Mutex{};
+			std::condition_variable Cv{};
+			std::thread TimerThread{};
+
+			// Guarded by both Mutex and the interrupt lock.
+			std::function<void()> Callback{};
+
+			uint32_t PeriodMicros = DefaultPeriodMicros;
+
+			// Incremented on every (re)configuration, so the timing thread restarts its schedule.
+			uint32_t ScheduleId = 0;
+
+			bool Enabled = false;
+			bool Exit = false;
+
+		private:
+			// Statistics, written only by the timing thread.
+			std::atomic<uint32_t> StatCount{ 0 };
+			std::atomic<uint32_t> StatMissed{ 0 };
+			std::atomic<uint32_t> StatLatencyMin{ UINT32_MAX };
+			std::atomic<uint32_t> StatLatencyMax{ 0 };
+			std::atomic<uint64_t> StatLatencySum{ 0 };
+
+		public:
+			ArduinoTimer(const HalBinding binding = {})
+				: Binding(binding)
+			{
+			}
+
+			ArduinoTimer(const ArduinoTimer&) = delete;
+			ArduinoTimer& operator=(const ArduinoTimer&) = delete;
+
+			~ArduinoTimer()
+			{
+				shutdown();
+			}
+
+		public:
+			// Sets the period and stops the timer, as TimerOne does.
+			void initialize(const uint32_t periodMicros = DefaultPeriodMicros)
+			{
+				std::lock_guard<std::mutex> lock(Mutex);
+				PeriodMicros = ClampPeriod(periodMicros);
+				Enabled = false;
+				ScheduleId++;
+				Cv.notify_all();
+			}
+
+			// Changes the period, restarting the schedule from now if running.
+			void setPeriod(const uint32_t periodMicros)
+			{
+				std::lock_guard<std::mutex> lock(Mutex);
+				PeriodMicros = ClampPeriod(periodMicros);
+				ScheduleId++;
+				Cv.notify_all();
+			}
+
+			uint32_t getPeriod()
+			{
+				std::lock_guard<std::mutex> lock(Mutex);
+				return PeriodMicros;
+			}
+
+			// Attaches the ISR callback and starts the timer.
+			// Optional period overrides the current one (0 keeps it).
+			void attachInterrupt(std::function<void()> isr, const uint32_t periodMicros = 0)
+			{
+				{
+					std::lock_guard<std::recursive_mutex> isrLock(GetInterruptLock());
+					std::lock_guard<std::mutex> lock(Mutex);
+					if (periodMicros > 0)
+						PeriodMicros = ClampPeriod(periodMicros);
+					Callback = std::move(isr);
+					Enabled = Callback != nullptr;
+					ScheduleId++;
+				}
+				ensureThread();
+				Cv.notify_all();
+			}
+
+			// Stops and removes the ISR callback.
+			// Returns after any in-flight ISR completes.
+			void detachInterrupt()
+			{
+				{
+					std::lock_guard<std::recursive_mutex> isrLock(GetInterruptLock());
+					std::lock_guard<std::mutex> lock(Mutex);
+					Enabled = false;
+					Callback = nullptr;
+					ScheduleId++;
+				}
+				Cv.notify_all();
+			}
+
+			// Starts counting a new period from now.
+			void start()
+			{
+				{
+					std::lock_guard<std::mutex> lock(Mutex);
+					Enabled = Callback != nullptr;
+					ScheduleId++;
+				}
+				ensureThread();
+				Cv.notify_all();
+			}
+
+			void restart()
+			{
+				start();
+			}
+
+			void resume()
+			{
+				start();
+			}
+
+			void stop()
+			{
+				std::lock_guard<std::mutex> lock(Mutex);
+				Enabled = false;
+				ScheduleId++;
+				Cv.notify_all();
+			}
+
+			bool isRunning()
+			{
+				std::lock_guard<std::mutex> lock(Mutex);
+				return Enabled;
+			}
+
+		public:
+			Statistics getStatistics() const
+			{
+				Statistics statistics{};
+				statistics.Count = StatCount.load(std::memory_order_relaxed);
+				statistics.Missed = StatMissed.load(std::memory_order_relaxed);
+				if (statistics.Count > 0)
+				{
+					statistics.LatencyMin = StatLatencyMin.load(std::memory_order_relaxed);
+					statistics.LatencyMax = StatLatencyMax.load(std::memory_order_relaxed);
+					statistics.LatencyAverage = static_cast<uint32_t>(StatLatencySum.load(std::memory_order_relaxed) / statistics.Count);
+					statistics.Jitter = statistics.LatencyMax - statistics.LatencyMin;
+				}
+				return statistics;
+			}
+
+			void resetStatistics()
+			{
+				StatCount.store(0, std::memory_order_relaxed);
+				StatMissed.store(0, std::memory_order_relaxed);
+				StatLatencyMin.store(UINT32_MAX, std::memory_order_relaxed);
+				StatLatencyMax.store(0, std::memory_order_relaxed);
+				StatLatencySum.store(0, std::memory_order_relaxed);
+			}
+
+		private:
+			void ensureThread()
+			{
+				std::lock_guard<std::mutex> lock(Mutex);
+				if (!TimerThread.joinable())
+				{
+					Exit = false;
+					TimerThread = std::thread(&ArduinoTimer::OnRun, this);
+				}
+			}
+
+			void shutdown()
+			{
+				{
+					std::lock_guard<std::mutex> lock(Mutex);
+					Exit = true;
+					Enabled = false;
+				}
+				Cv.notify_all();
+
+				if (TimerThread.joinable())
+				{
+					if (std::this_thread::get_id() == TimerThread.get_id())
+						TimerThread.detach();
+					else
+						TimerThread.join();
+				}
+			}
+
+			// The owner's interrupt mask, whichever thread (re)configures the timer.
+			std::recursive_mutex& GetInterruptLock()
+			{
+				if (Binding.InterruptLock != nullptr)
+					return *Binding.InterruptLock;
+				return InterruptState::Lock();
+			}
+
+			// Timing thread entry point.
+			void OnRun()
+			{
+				HalBinding::Current() = Binding;
+
+				std::unique_lock<std::mutex> lock(Mutex);
+
+				while (!Exit)
+				{
+					if (!Enabled)
+					{
+						Cv.wait(lock, [this]() { return Exit || Enabled; });
+						continue;
+					}
+
+					// (Re)start the schedule.
+					const uint32_t scheduleId = ScheduleId;
+					const Clock::duration period = std::chrono::microseconds(PeriodMicros);
+					Clock::time_point deadline = Clock::now() + period;
+
+					while (!Exit && Enabled && scheduleId == ScheduleId)
+					{
+						// Coarse sleep, interruptible by reconfiguration.
+						const Clock::time_point wakeup = deadline - std::chrono::microseconds(static_cast<uint32_t>(SpinThresholdMicros));
+						if (Clock::now() < wakeup)
+						{
+							Cv.wait_until(lock, wakeup, [this, scheduleId]() { return Exit || !Enabled || scheduleId != ScheduleId; });
+							continue;
+						}
+
+						// Fine spin to the deadline.
+						lock.unlock();
+						while (Clock::now() < deadline)
+						{
+							std::this_thread::yield();
+						}
+						lock.lock();
+
+						if (Exit || !Enabled || scheduleId != ScheduleId)
+							continue;
+
+						lock.unlock();
+						fire(deadline);
+						lock.lock();
+
+						// Next deadline, skipping ticks that are already a full period late.
+						deadline += period;
+						const Clock::time_point now = Clock::now();
+						if (now >= deadline + period)
+						{
+							const uint32_t missed = static_cast<uint32_t>((now - deadline) / period);
+							deadline += period * missed;
+							StatMissed.fetch_add(missed, std::memory_order_relaxed);
+						}
+					}
+				}
+			}
+
+			void fire(const Clock::time_point deadline)
+			{
+				// Callback is only replaced while holding the interrupt lock.
+				std::lock_guard<std::recursive_mutex> isrLock(GetInterruptLock());
+
+				if (!Callback)
+					return;
+
+				const uint32_t latency = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - deadline).count());
+
+				// The interrupt lock is recursive, so the ISR may attach or detach itself (one-shot pattern):
+				// run a copy, Callback can be replaced under it.
+				const std::function<void()> isr = Callback;
+				isr();
+
+				StatCount.fetch_add(1, std::memory_order_relaxed);
+				StatLatencySum.fetch_add(latency, std::memory_order_relaxed);
+				if (latency < StatLatencyMin.load(std::memory_order_relaxed))
+					StatLatencyMin.store(latency, std::memory_order_relaxed);
+				if (latency > StatLatencyMax.load(std::memory_order_relaxed))
+					StatLatencyMax.store(latency, std::memory_order_relaxed);
+			}
+
+			static uint32_t ClampPeriod(const uint32_t periodMicros)
+			{
+				return periodMicros > 0 ? periodMicros : 1;
+			}
+		};
+	}
+}
\ No newline at end of file
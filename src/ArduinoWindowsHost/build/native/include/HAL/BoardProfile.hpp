@@ -0,0 +1,55 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "SerialTiming.hpp"
+
+namespace ArduinoWindowsHost
+{
+	namespace Hal
+	{
+		// Most serial ports a board profile can have, Serial to Serial3 (as on a Mega).
+		static constexpr uint8_t MaxSerialCount = 4;
+
+		/// <summary>
+		/// Board profile: the HAL dimensions of an emulated board, fixed at compile time.
+		/// Derive from it and shadow the constants to change them, then host with TemplateLoopHost<Profile>.
+		/// Every port gets the same capacities; ports past SerialCount don't exist on the board.
+		/// </summary>
+		struct DefaultBoardProfile
+		{
+			static constexpr uint8_t IoCount = 32;
+			static constexpr uint8_t SerialCount = 3;
+
+			static constexpr size_t SerialLineCapacity = 2048;		// TX lines kept in the line log.
+			static constexpr size_t SerialRxCapacity = 256;			// RX ring bytes.
+			static constexpr size_t SerialTxCapacity = 64 * 1024;	// TX line log bytes.
+			static constexpr size_t SerialTxRawCapacity = 0;		// Raw TX channel bytes, 0 until a consumer enables it.
+
+			// Baud rate model applied to every port, see ArduinoSerialPort::SetTiming().
+			static constexpr SerialTiming SerialTimingMode = SerialTiming::Off;
+			static constexpr size_t SerialTxFifo = SerialTimingModel::DefaultTxFifo;
+		};
+
+		// Minimal board for mass simulation: 16 pins, Serial only, small buffers and no raw TX channel.
+		// A few KB per host, instead of the default's few hundred.
+		struct CompactBoardProfile : DefaultBoardProfile
+		{
+			static constexpr uint8_t IoCount = 16;
+			static constexpr uint8_t SerialCount = 1;
+
+			static constexpr size_t SerialLineCapacity = 32;
+			static constexpr size_t SerialRxCapacity = 64;
+			static constexpr size_t SerialTxCapacity = 1024;
+			static constexpr size_t SerialTxRawCapacity = 0;
+		};
+
+		// Mega 2560 layout: 70 pins and 4 serial ports.
+		struct MegaBoardProfile : DefaultBoardProfile
+		{
+			static constexpr uint8_t IoCount = 70;
+			static constexpr uint8_t SerialCount = 4;
+		};
+	}
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stdint.h>
+#include <mutex>
+
+namespace ArduinoWindowsHost
+{
+	namespace Hal
+	{
+		class HalContext;
+
+		// HAL state bound to the calling thread: set by HalContext::Scope on host loop and timer threads,
+		// empty elsewhere. Kept apart from HalContext so the peripherals it owns can resolve it without a cycle.
+		struct HalBinding
+		{
+			HalContext* Context = nullptr;
+			std::recursive_mutex* InterruptLock = nullptr;
+
+			static HalBinding& Current()
+			{
+				static thread_local HalBinding binding{};
+				return binding;
+			}
+		};
+	}
+}
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+#include <utility>
+
+#include "HalBinding.hpp"
+#include "BoardProfile.hpp"
+#include "ArduinoIo.hpp"
+#include "ArduinoSerialPort.hpp"
+#include "ArduinoTimer.hpp"
+
+namespace ArduinoWindowsHost
+{
+	namespace Hal
+	{
+		/// <summary>
+		/// One emulated board: serial ports, pins, timer, boot clock, loop counter and interrupt mask.
+		/// Each LoopHost owns one and binds it to its loop thread (and its timer thread),
+		/// so the Arduino API (Serial, digitalWrite(), millis(), ...) resolves to the running host's board.
+		/// Threads without a binding (UI, tools) see the process Default() context.
+		/// Ports and pins are dimensioned by a board profile, see TemplateHalContext.
+		/// </summary>
+		class HalContext
+		{
+		public:
+			/// <summary>
+			/// Binds a context to the calling thread for the scope's lifetime, restoring the previous binding after.
+			/// </summary>
+			class Scope
+			{
+			private:
+				const HalBinding Previous;
+
+			public:
+				Scope(HalContext& context)
+					: Previous(HalBinding::Current())
+				{
+					HalBinding::Current() = context.GetBinding();
+				}
+
+				Scope(const Scope&) = delete;
+				Scope& operator=(const Scope&) = delete;
+
+				~Scope()
+				{
+					HalBinding::Current() = Previous;
+				}
+			};
+
+		private:
+			ArduinoSerialPort* const Uarts;
+			const uint8_t UartCount;
+
+		public:
+			std::atomic<uint32_t> Iteration{ 0 };
+			std::recursive_mutex InterruptLock{};
+
+			std::atomic<uint32_t> BootMillis{ 0 };
+			std::atomic<uint32_t> BootMicros{ 0 };
+
+			// Serial to Serial3. Ports the profile doesn't have are Unconnected().
+			ArduinoSerialPort& Uart0;
+			ArduinoSerialPort& Uart1;
+			ArduinoSerialPort& Uart2;
+			ArduinoSerialPort& Uart3;
+
+			ArduinoPins& Io;
+
+			// Declared last: its timing thread binds the members above.
+			ArduinoTimer Timer{ GetBinding() };
+
+		protected:
+			HalContext(ArduinoSerialPort* uarts, const uint8_t uartCount, ArduinoPins& io)
+				: Uarts(uarts)
+				, UartCount(uartCount)
+				, Uart0(GetUart(0))
+				, Uart1(GetUart(1))
+				, Uart2(GetUart(2))
+				, Uart3(GetUart(3))
+				, Io(io)
+			{
+				for (uint8_t i = 0; i < UartCount; i++)
+					Uarts[i].SetIterationSource(Iteration);
+			}
+
+		public:
+			HalContext(const HalContext&) = delete;
+			HalContext& operator=(const HalContext&) = delete;
+
+			virtual ~HalContext() = default;
+
+			uint8_t GetUartCount() const
+			{
+				return UartCount;
+			}
+
+			ArduinoSerialPort& GetUart(const uint8_t index)
+			{
+				if (index < UartCount)
+					return Uarts[index];
+				return Unconnected();
+			}
+
+			HalBinding GetBinding()
+			{
+				HalBinding binding{};
+				binding.Context = this;
+				binding.InterruptLock = &InterruptLock;
+				return binding;
+			}
+
+			// The context bound to the calling thread, or the process default.
+			static HalContext& Current()
+			{
+				HalContext* bound = HalBinding::Current().Context;
+				if (bound != nullptr)
+					return *bound;
+				return Default();
+			}
+
+			// Shared by every thread without a binding, a DefaultBoardProfile board.
+			static HalContext& Default();
+
+			// Stands in for ports a board doesn't have, shared by all boards: a minimal port nothing reads.
+			static ArduinoSerialPort& Unconnected()
+			{
+				static ArduinoSerialPort port(UINT8_MAX, 1, 16, 16, 0);
+				return port;
+			}
+		};
+
+		// Profile sized storage, a base of TemplateHalContext so it's built before HalContext and outlives its timer.
+		template<typename Profile>
+		struct TemplateHalStorage
+		{
+			static_assert(Profile::SerialCount > 0 && Profile::SerialCount <= MaxSerialCount, "SerialCount must be 1 to MaxSerialCount.");
+
+			ArduinoSerialPort Ports[Profile::SerialCount];
+			ArduinoIo<Profile::IoCount> Pins{};
+
+			template<size_t... Index>
+			TemplateHalStorage(std::index_sequence<Index...>)
+				: Ports{ { static_cast<uint8_t>(Index), Profile::SerialLineCapacity, Profile::SerialRxCapacity, Profile::SerialTxCapacity, Profile::SerialTxRawCapacity }... }
+			{
+				if (Profile::SerialTimingMode != SerialTiming::Off)
+				{
+					for (ArduinoSerialPort& port : Ports)
+						port.SetTiming(Profile::SerialTimingMode, Profile::SerialTxFifo);
+				}
+			}
+		};
+
+		/// <summary>
+		/// HalContext dimensioned by a board profile (see DefaultBoardProfile).
+		/// </summary>
+		template<typename Profile = DefaultBoardProfile>
+		class TemplateHalContext : private TemplateHalStorage<Profile>, public HalContext
+		{
+		private:
+			using StorageType = TemplateHalStorage<Profile>;
+
+		public:
+			using BoardProfile = Profile;
+
+		public:
+			TemplateHalContext()
+				: StorageType(std::make_index_sequence<Profile::SerialCount>())
+				, HalContext(StorageType::Ports, Profile::SerialCount, StorageType::Pins)
+			{
+			}
+		};
+
+		inline HalContext& HalContext::Default()
+		{
+			static TemplateHalContext<DefaultBoardProfile> context{};
+			return context;
+		}
+	}
+}
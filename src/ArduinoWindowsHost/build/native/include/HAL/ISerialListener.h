@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "SerialLineLog.hpp"
+
+namespace ArduinoWindowsHost
+{
+	namespace Hal
+	{
+		/// <summary>
+		/// Serial port subscriber, registered with ArduinoSerialPort::addListener().
+		/// Callbacks run synchronously on the thread producing the data, so keep them short
+		/// and hand heavier work off to another thread.
+		/// </summary>
+		class ISerialListener
+		{
+		public:
+			// A TX line was completed, info holds its sequence, timestamp and loop iteration.
+			// Runs under the port's TX lock: line is only valid for the duration of the call
+			// and the port's TX API must not be called from here.
+			virtual void OnSerialTxLine(const uint8_t portId, const SerialLineLog::LineInfo& info, const char* line, const size_t length) {}
+
+			// The TX log was flushed (flushTx()).
+			virtual void OnSerialTxFlush(const uint8_t portId) {}
+
+			// Bytes were accepted into the raw TX channel (see SetTxLineLog()). Runs on the writer's thread, in order.
+			virtual void OnSerialTxRaw(const uint8_t portId, const uint8_t* data, const size_t length) {}
+
+			// Bytes were accepted into the RX buffer, during the owning board's loop iteration.
+			// Runs on the Rx() caller's thread, in order.
+			virtual void OnSerialRx(const uint8_t portId, const uint32_t iteration, const uint8_t* data, const size_t length) {}
+		};
+	}
+}
\ No newline at end of file
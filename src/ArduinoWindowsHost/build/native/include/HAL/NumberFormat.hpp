@@ -0,0 +1,242 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <cmath>
+#include <type_traits>
+
+namespace ArduinoWindowsHost
+{
+	namespace Hal
+	{
+		// Arduino print() bases.
+		static constexpr uint8_t DEC = 10;
+		static constexpr uint8_t HEX = 16;
+		static constexpr uint8_t OCT = 8;
+		static constexpr uint8_t BIN = 2;
+
+		/// <summary>
+		/// Allocation-free number to text conversion, matching Arduino's Print output.
+		/// - Integers in any base 2-36 (digits above 9 upper case), written straight into a caller stack buffer.
+		///   Base 0 emits the value as a raw byte, other bases below 2 fall back to DEC.
+		/// - Negative values get a '-' in DEC only, other bases print the two's complement bits.
+		/// - Floats use Arduino's fixed point rounding: "nan", "inf" and "ovf" outside +-4294967040.
+		/// </summary>
+		struct NumberFormat
+		{
+			// Longest integer text: 64 binary digits plus sign.
+			static constexpr size_t MaxIntegerLength = 65;
+
+			// Fraction digits are capped, double holds no more.
+			static constexpr uint8_t MaxFloatDigits = 20;
+
+			// Longest float text: sign, 10 integer digits, point and fraction.
+			static constexpr size_t MaxFloatLength = 1 + 10 + 1 + MaxFloatDigits;
+
+			// Writes value to buffer (at least MaxIntegerLength), returns the text length. Not null terminated.
+			template<typename T>
+			static size_t FormatInteger(char* buffer, const T value, const uint8_t base = DEC)
+			{
+				static_assert(std::is_integral<T>::value, "Integer types only.");
+				using Unsigned = typename std::make_unsigned<T>::type;
+
+				if (base == 0)
+				{
+					buffer[0] = static_cast<char>(value);
+					return 1;
+				}
+
+				if (IsNegative(value) && (base == DEC || base < 2))
+				{
+					buffer[0] = '-';
+					return 1 + FormatUnsigned(buffer + 1, static_cast<uint64_t>(Unsigned(0) - static_cast<Unsigned>(value)), DEC);
+				}
+
+				return FormatUnsigned(buffer, static_cast<uint64_t>(static_cast<Unsigned>(value)), base);
+			}
+
+			// Writes value with digits fraction digits to buffer (at least MaxFloatLength), returns the text length.
+			static size_t FormatFloat(char* buffer, double value, uint8_t digits = 2)
+			{
+				if (std::isnan(value))
+					return Copy(buffer, "nan");
+				if (std::isinf(value))
+					return Copy(buffer, "inf");
+				if (value > 4294967040.0 || value < -4294967040.0)
+					return Copy(buffer, "ovf");
+
+				if (digits > MaxFloatDigits)
+					digits = MaxFloatDigits;
+
+				size_t length = 0;
+				if (value < 0.0)
+				{
+					buffer[length++] = '-';
+					value = -value;
+				}
+
+				// Round half up at the last printed digit.
+				double rounding = 0.5;
+				for (uint8_t i = 0; i < digits; i++)
+					rounding /= 10.0;
+				value += rounding;
+
+				const uint32_t integer = static_cast<uint32_t>(value);
+				double remainder = value - static_cast<double>(integer);
+				length += FormatUnsigned(buffer + length, integer, DEC);
+
+				if (digits > 0)
+				{
+					buffer[length++] = '.';
+					for (uint8_t i = 0; i < digits; i++)
+					{
+						remainder *= 10.0;
+						const uint8_t digit = static_cast<uint8_t>(remainder);
+						buffer[length++] = static_cast<char>('0' + digit);
+						remainder -= digit;
+					}
+				}
+
+				return length;
+			}
+
+			// Writes value to buffer in base (2-36, others as DEC), returns the text length.
+			static size_t FormatUnsigned(char* buffer, uint64_t value, const uint8_t base)
+			{
+				switch (base)
+				{
+				case 2:
+					return FormatPowerOf2(buffer, value, 1);
+				case 8:
+					return FormatPowerOf2(buffer, value, 3);
+				case 16:
+					return FormatPowerOf2(buffer, value, 4);
+				default:
+					if (base < 2 || base > 36 || base == 10)
+						return FormatDecimal(buffer, value);
+					break;
+				}
+
+				// Other bases: generic division, written backwards then moved.
+				char scratch[MaxIntegerLength];
+				size_t start = MaxIntegerLength;
+				do
+				{
+					const uint8_t digit = static_cast<uint8_t>(value % base);
+					scratch[--start] = DigitChar(digit);
+					value /= base;
+				} while (value > 0);
+
+				const size_t length = MaxIntegerLength - start;
+				memcpy(buffer, &scratch[start], length);
+				return length;
+			}
+
+		private:
+			template<typename T>
+			static bool IsNegative(const T value, std::true_type)
+			{
+				return value < 0;
+			}
+
+			template<typename T>
+			static bool IsNegative(const T, std::false_type)
+			{
+				return false;
+			}
+
+			template<typename T>
+			static bool IsNegative(const T value)
+			{
+				return IsNegative(value, std::is_signed<T>{});
+			}
+
+			// Two digits per division, from a pair table.
+			static size_t FormatDecimal(char* buffer, uint64_t value)
+			{
+				static constexpr char Pairs[] =
+					"00010203040506070809"
+					"10111213141516171819"
+					"20212223242526272829"
+					"30313233343536373839"
+					"40414243444546474849"
+					"50515253545556575859"
+					"60616263646566676869"
+					"70717273747576777879"
+					"80818283848586878889"
+					"90919293949596979899";
+
+				const size_t length = CountDecimalDigits(value);
+				size_t position = length;
+				while (value >= 100)
+				{
+					const size_t pair = static_cast<size_t>(value % 100) * 2;
+					value /= 100;
+					buffer[--position] = Pairs[pair + 1];
+					buffer[--position] = Pairs[pair];
+				}
+
+				if (value >= 10)
+				{
+					const size_t pair = static_cast<size_t>(value) * 2;
+					buffer[--position] = Pairs[pair + 1];
+					buffer[--position] = Pairs[pair];
+				}
+				else
+				{
+					buffer[--position] = static_cast<char>('0' + value);
+				}
+
+				return length;
+			}
+
+			// Shift and mask, digit count from the highest set bit.
+			static size_t FormatPowerOf2(char* buffer, uint64_t value, const uint8_t shift)
+			{
+				uint8_t bits = 1;
+				for (uint64_t v = value >> 1; v != 0; v >>= 1)
+					bits++;
+
+				const size_t length = (bits + shift - 1) / shift;
+				const uint64_t mask = (UINT64_C(1) << shift) - 1;
+				for (size_t position = length; position > 0; position--)
+				{
+					buffer[position - 1] = DigitChar(static_cast<uint8_t>(value & mask));
+					value >>= shift;
+				}
+
+				return length;
+			}
+
+			static size_t CountDecimalDigits(uint64_t value)
+			{
+				size_t digits = 1;
+				while (value >= 10000)
+				{
+					value /= 10000;
+					digits += 4;
+				}
+				if (value >= 1000)
+					return digits + 3;
+				if (value >= 100)
+					return digits + 2;
+				if (value >= 10)
+					return digits + 1;
+				return digits;
+			}
+
+			static char DigitChar(const uint8_t digit)
+			{
+				return static_cast<char>(digit < 10 ? '0' + digit : 'A' + digit - 10);
+			}
+
+			static size_t Copy(char* buffer, const char* text)
+			{
+				const size_t length = strlen(text);
+				memcpy(buffer, text, length);
+				return length;
+			}
+		};
+	}
+}
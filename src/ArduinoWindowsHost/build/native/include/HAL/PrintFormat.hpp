@@ -0,0 +1,548 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <cmath>
+#include <string.h>
+#include <string>
+#include <type_traits>
+
+#include "NumberFormat.hpp"
+
+namespace ArduinoWindowsHost
+{
+	namespace Hal
+	{
+#if !defined(ARDUINO)
+		struct __FlashStringHelper; // forward (host)
+#endif
+
+		// Base of the format literal types made by FMT("..."), see Print::printf().
+		struct FormatLiteral {};
+
+		/// <summary>
+		/// printf() argument, captured by type so the format doesn't have to describe it.
+		/// Length modifiers in the format (h, l, ll, z, ...) are accepted and ignored.
+		/// </summary>
+		struct FormatArg
+		{
+			enum class Kind : uint8_t
+			{
+				None,		// Past the last argument.
+				Signed,
+				Unsigned,
+				Float,
+				String,
+				Pointer,
+				Unsupported
+			};
+
+			Kind Type = Kind::None;
+			uint8_t Size = 0; // Integer width in bytes, for two's complement %x/%o/%u of negative values.
+			union
+			{
+				int64_t Signed;
+				uint64_t Unsigned;
+				double Float;
+				const char* String;
+				const void* Pointer;
+			} Value{};
+			size_t Length = SIZE_MAX; // String length, SIZE_MAX for null terminated.
+
+			FormatArg() = default;
+
+			template<typename T, typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value, int>::type = 0>
+			FormatArg(const T value) : Type(Kind::Signed), Size(sizeof(T)) { Value.Signed = value; }
+
+			template<typename T, typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value, int>::type = 0>
+			FormatArg(const T value) : Type(Kind::Unsigned), Size(sizeof(T)) { Value.Unsigned = value; }
+
+			template<typename T, typename std::enable_if<std::is_enum<T>::value, int>::type = 0>
+			FormatArg(const T value) : FormatArg(static_cast<typename std::underlying_type<T>::type>(value)) {}
+
+			FormatArg(const double value) : Type(Kind::Float) { Value.Float = value; }
+			FormatArg(const char* value) : Type(Kind::String) { Value.String = value; }
+			FormatArg(const __FlashStringHelper* value) : Type(Kind::String) { Value.String = reinterpret_cast<const char*>(value); }
+			FormatArg(const std::string& value) : Type(Kind::String), Length(value.size()) { Value.String = value.data(); }
+			FormatArg(const void* value) : Type(Kind::Pointer) { Value.Pointer = value; }
+			FormatArg(std::nullptr_t) : Type(Kind::Pointer) { Value.Pointer = nullptr; }
+		};
+
+		// Compile time argument classification (of decayed types), mirrors FormatArg's constructors.
+		template<typename T, typename = void>
+		struct FormatArgKind
+		{
+			static constexpr FormatArg::Kind value = std::is_pointer<T>::value ? FormatArg::Kind::Pointer : FormatArg::Kind::Unsupported;
+		};
+
+		template<typename T>
+		struct FormatArgKind<T, typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type>
+		{
+			static constexpr FormatArg::Kind value = (std::is_enum<T>::value || std::is_signed<T>::value) ? FormatArg::Kind::Signed : FormatArg::Kind::Unsigned;
+		};
+
+		template<typename T>
+		struct FormatArgKind<T, typename std::enable_if<std::is_floating_point<T>::value>::type>
+		{
+			static constexpr FormatArg::Kind value = FormatArg::Kind::Float;
+		};
+
+		template<> struct FormatArgKind<char*> { static constexpr FormatArg::Kind value = FormatArg::Kind::String; };
+		template<> struct FormatArgKind<const char*> { static constexpr FormatArg::Kind value = FormatArg::Kind::String; };
+		template<> struct FormatArgKind<const __FlashStringHelper*> { static constexpr FormatArg::Kind value = FormatArg::Kind::String; };
+		template<> struct FormatArgKind<std::string> { static constexpr FormatArg::Kind value = FormatArg::Kind::String; };
+		template<> struct FormatArgKind<std::nullptr_t> { static constexpr FormatArg::Kind value = FormatArg::Kind::Pointer; };
+
+		/// <summary>
+		/// printf() format engine: C printf conversions (d i u x X o c s p f F e E g G a A %) with
+		/// flags, width, precision and '*' arguments, written in chunks to any sink.
+		/// The same parser runs at compile time (Check()) to reject format/argument mismatches,
+		/// and at run time to format; integers go through NumberFormat, floats through snprintf on the stack.
+		/// </summary>
+		struct PrintFormat
+		{
+			enum class Error : uint8_t
+			{
+				None,
+				MissingArgument,	// More conversions than arguments.
+				ExtraArgument,		// More arguments than conversions.
+				TypeMismatch,		// Argument doesn't suit the conversion.
+				BadConversion		// Unknown or unsupported conversion (e.g. %n).
+			};
+
+			struct Spec
+			{
+				bool Left = false;
+				bool Plus = false;
+				bool Space = false;
+				bool Alternate = false;
+				bool Zero = false;
+				bool WidthArg = false;		// '*' width.
+				bool PrecisionArg = false;	// '*' precision.
+				int Width = 0;
+				int Precision = -1;
+				char Conversion = 0;
+			};
+
+			// Parses the conversion spec after a '%' at format[index], returns the index past it.
+			static constexpr size_t ParseSpec(const char* format, size_t index, Spec& spec)
+			{
+				for (;; index++)
+				{
+					const char c = format[index];
+					if (c == '-') spec.Left = true;
+					else if (c == '+') spec.Plus = true;
+					else if (c == ' ') spec.Space = true;
+					else if (c == '#') spec.Alternate = true;
+					else if (c == '0') spec.Zero = true;
+					else break;
+				}
+
+				if (format[index] == '*')
+				{
+					spec.WidthArg = true;
+					index++;
+				}
+				else
+				{
+					while (format[index] >= '0' && format[index] <= '9')
+						spec.Width = spec.Width * 10 + (format[index++] - '0');
+				}
+
+				if (format[index] == '.')
+				{
+					index++;
+					spec.Precision = 0;
+					if (format[index] == '*')
+					{
+						spec.PrecisionArg = true;
+						index++;
+					}
+					else
+					{
+						while (format[index] >= '0' && format[index] <= '9')
+							spec.Precision = spec.Precision * 10 + (format[index++] - '0');
+					}
+				}
+
+				// Length modifiers, the argument type is already known.
+				while (format[index] == 'h' || format[index] == 'l' || format[index] == 'L'
+					|| format[index] == 'z' || format[index] == 'j' || format[index] == 't' || format[index] == 'q')
+					index++;
+
+				spec.Conversion = format[index];
+				return format[index] != 0 ? index + 1 : index;
+			}
+
+			// Whether an argument of kind suits conversion.
+			static constexpr bool Accepts(const char conversion, const FormatArg::Kind kind)
+			{
+				switch (conversion)
+				{
+				case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'c':
+					return kind == FormatArg::Kind::Signed || kind == FormatArg::Kind::Unsigned;
+				case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+					return kind == FormatArg::Kind::Float;
+				case 's':
+					return kind == FormatArg::Kind::String;
+				case 'p':
+					return kind == FormatArg::Kind::Pointer || kind == FormatArg::Kind::String;
+				default:
+					return false;
+				}
+			}
+
+			static constexpr bool IsConversion(const char conversion)
+			{
+				switch (conversion)
+				{
+				case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'c':
+				case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+				case 's': case 'p':
+					return true;
+				default:
+					return false;
+				}
+			}
+
+			static constexpr bool IsInteger(const FormatArg::Kind kind)
+			{
+				return kind == FormatArg::Kind::Signed || kind == FormatArg::Kind::Unsigned;
+			}
+
+			// Validates format against the argument kinds (kinds[count] is the None terminator).
+			static constexpr Error Check(const char* format, const FormatArg::Kind* kinds, const size_t count)
+			{
+				size_t arg = 0;
+				size_t index = 0;
+				while (format[index] != 0)
+				{
+					if (format[index++] != '%')
+						continue;
+
+					if (format[index] == '%')
+					{
+						index++;
+						continue;
+					}
+
+					Spec spec{};
+					index = ParseSpec(format, index, spec);
+
+					if (spec.WidthArg)
+					{
+						if (arg >= count)
+							return Error::MissingArgument;
+						if (!IsInteger(kinds[arg++]))
+							return Error::TypeMismatch;
+					}
+					if (spec.PrecisionArg)
+					{
+						if (arg >= count)
+							return Error::MissingArgument;
+						if (!IsInteger(kinds[arg++]))
+							return Error::TypeMismatch;
+					}
+
+					if (!IsConversion(spec.Conversion))
+						return Error::BadConversion;
+					if (arg >= count)
+						return Error::MissingArgument;
+					if (!Accepts(spec.Conversion, kinds[arg++]))
+						return Error::TypeMismatch;
+				}
+
+				return arg < count ? Error::ExtraArgument : Error::None;
+			}
+
+			/// <summary>
+			/// Formats into sink.write(const char*, size_t), in chunks of ChunkSize bytes (one call for most lines).
+			/// Run time mismatches (formats not checked at compile time) print as "%!" plus the conversion.
+			/// Returns the number of bytes written.
+			/// </summary>
+			template<typename Sink>
+			static size_t Format(Sink& sink, const char* format, const FormatArg* args, const size_t count)
+			{
+				Output<Sink> out(sink);
+				size_t arg = 0;
+
+				while (*format != 0)
+				{
+					// Literal run.
+					const char* literal = format;
+					while (*format != 0 && *format != '%')
+						format++;
+					out.put(literal, static_cast<size_t>(format - literal));
+					if (*format == 0)
+						break;
+
+					format++;
+					if (*format == '%')
+					{
+						out.put('%');
+						format++;
+						continue;
+					}
+
+					Spec spec{};
+					format += ParseSpec(format, 0, spec);
+
+					if (spec.WidthArg)
+					{
+						const int width = arg < count && IsInteger(args[arg].Type) ? static_cast<int>(args[arg].Value.Signed) : 0;
+						arg++;
+						if (width < 0)
+						{
+							spec.Left = true;
+							spec.Width = -width;
+						}
+						else
+						{
+							spec.Width = width;
+						}
+					}
+					if (spec.PrecisionArg)
+					{
+						const int precision = arg < count && IsInteger(args[arg].Type) ? static_cast<int>(args[arg].Value.Signed) : -1;
+						arg++;
+						spec.Precision = precision < 0 ? -1 : precision;
+					}
+
+					if (arg >= count || !IsConversion(spec.Conversion) || !Accepts(spec.Conversion, args[arg].Type))
+					{
+						out.put("%!", 2);
+						if (spec.Conversion != 0)
+							out.put(spec.Conversion);
+						arg++;
+						continue;
+					}
+
+					FormatOne(out, spec, args[arg++]);
+				}
+
+				return out.finish();
+			}
+
+		private:
+			static constexpr size_t ChunkSize = 128;
+
+			// Stack chunk in front of the sink.
+			template<typename Sink>
+			class Output
+			{
+			private:
+				Sink& Target;
+				char Chunk[ChunkSize];
+				size_t Length = 0;
+				size_t Written = 0;
+
+			public:
+				Output(Sink& target) : Target(target) {}
+
+				void put(const char c)
+				{
+					if (Length == ChunkSize)
+						drain();
+					Chunk[Length++] = c;
+				}
+
+				void put(const char* text, size_t length)
+				{
+					while (length > 0)
+					{
+						if (Length == ChunkSize)
+							drain();
+						const size_t room = ChunkSize - Length;
+						const size_t count = length < room ? length : room;
+						memcpy(&Chunk[Length], text, count);
+						Length += count;
+						text += count;
+						length -= count;
+					}
+				}
+
+				void pad(const char c, int count)
+				{
+					while (count-- > 0)
+						put(c);
+				}
+
+				size_t finish()
+				{
+					drain();
+					return Written;
+				}
+
+			private:
+				void drain()
+				{
+					if (Length > 0)
+						Written += Target.write(Chunk, Length);
+					Length = 0;
+				}
+			};
+
+			template<typename Sink>
+			static void FormatOne(Output<Sink>& out, const Spec& spec, const FormatArg& arg)
+			{
+				switch (spec.Conversion)
+				{
+				case 'c':
+				{
+					const char c = static_cast<char>(arg.Value.Unsigned);
+					Padded(out, spec, "", 0, 0, &c, 1);
+					break;
+				}
+				case 's':
+				{
+					const char* text = arg.Value.String != nullptr ? arg.Value.String : "(null)";
+					const size_t limit = spec.Precision >= 0 ? static_cast<size_t>(spec.Precision) : SIZE_MAX;
+					const size_t available = arg.Value.String != nullptr ? arg.Length : SIZE_MAX;
+					size_t length = 0;
+					while (length < limit && length < available && text[length] != 0)
+						length++;
+					Padded(out, spec, "", 0, 0, text, length);
+					break;
+				}
+				case 'p':
+				{
+					char digits[NumberFormat::MaxIntegerLength];
+					const size_t length = NumberFormat::FormatUnsigned(digits, reinterpret_cast<uintptr_t>(arg.Value.Pointer), HEX);
+					LowerCase(digits, length);
+					Padded(out, spec, "0x", 2, 0, digits, length);
+					break;
+				}
+				case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+					FormatFloat(out, spec, arg.Value.Float);
+					break;
+				default:
+					FormatInteger(out, spec, arg);
+					break;
+				}
+			}
+
+			template<typename Sink>
+			static void FormatInteger(Output<Sink>& out, const Spec& spec, const FormatArg& arg)
+			{
+				const bool isSigned = spec.Conversion == 'd' || spec.Conversion == 'i';
+				const uint64_t mask = arg.Size >= 8 ? UINT64_MAX : ((UINT64_C(1) << (arg.Size * 8)) - 1);
+
+				bool negative = false;
+				uint64_t magnitude = arg.Value.Unsigned;
+				if (arg.Type == FormatArg::Kind::Signed && isSigned && arg.Value.Signed < 0)
+				{
+					negative = true;
+					magnitude = UINT64_C(0) - static_cast<uint64_t>(arg.Value.Signed);
+				}
+				else if (!isSigned)
+				{
+					magnitude &= mask;
+				}
+
+				const uint8_t base = (spec.Conversion == 'x' || spec.Conversion == 'X') ? HEX : (spec.Conversion == 'o' ? OCT : DEC);
+
+				char digits[NumberFormat::MaxIntegerLength];
+				size_t length = 0;
+				if (!(magnitude == 0 && spec.Precision == 0))
+				{
+					length = NumberFormat::FormatUnsigned(digits, magnitude, base);
+					if (spec.Conversion == 'x')
+						LowerCase(digits, length);
+				}
+
+				char prefix[2]{};
+				size_t prefixLength = 0;
+				if (negative) prefix[prefixLength++] = '-';
+				else if (isSigned && spec.Plus) prefix[prefixLength++] = '+';
+				else if (isSigned && spec.Space) prefix[prefixLength++] = ' ';
+				else if (spec.Alternate && magnitude != 0 && base == HEX)
+				{
+					prefix[prefixLength++] = '0';
+					prefix[prefixLength++] = spec.Conversion;
+				}
+
+				int zeros = spec.Precision > static_cast<int>(length) ? spec.Precision - static_cast<int>(length) : 0;
+				if (spec.Alternate && base == OCT && zeros == 0 && (length == 0 || digits[0] != '0'))
+					zeros = 1;
+
+				// '0' flag pads with zeros after the prefix, unless a precision is given.
+				if (spec.Zero && !spec.Left && spec.Precision < 0)
+				{
+					const int used = static_cast<int>(prefixLength + length) + zeros;
+					if (spec.Width > used)
+						zeros += spec.Width - used;
+				}
+
+				Padded(out, spec, prefix, prefixLength, zeros, digits, length);
+			}
+
+			template<typename Sink>
+			static void FormatFloat(Output<Sink>& out, const Spec& spec, const double value)
+			{
+				// Precision is capped so %f of the largest double fits.
+				static constexpr int MaxPrecision = 100;
+
+				char conversion[12]{};
+				size_t index = 0;
+				conversion[index++] = '%';
+				if (spec.Plus) conversion[index++] = '+';
+				if (spec.Space) conversion[index++] = ' ';
+				if (spec.Alternate) conversion[index++] = '#';
+				if (spec.Precision >= 0)
+				{
+					const int precision = spec.Precision < MaxPrecision ? spec.Precision : MaxPrecision;
+					conversion[index++] = '.';
+					index += NumberFormat::FormatUnsigned(&conversion[index], static_cast<uint64_t>(precision), DEC);
+				}
+				conversion[index++] = spec.Conversion;
+
+				char text[512];
+				int length = snprintf(text, sizeof(text), conversion, value);
+				if (length < 0)
+					return;
+				if (length >= static_cast<int>(sizeof(text)))
+					length = sizeof(text) - 1;
+
+				// Sign (and %a's 0x) go before zero padding, inf/nan are never zero padded.
+				size_t prefixLength = (text[0] == '-' || text[0] == '+' || text[0] == ' ') ? 1 : 0;
+				const bool finite = std::isfinite(value);
+				if (finite && (spec.Conversion == 'a' || spec.Conversion == 'A'))
+					prefixLength += 2;
+				int zeros = 0;
+				if (spec.Zero && !spec.Left && finite && spec.Width > length)
+					zeros = spec.Width - length;
+
+				Padded(out, spec, text, prefixLength, zeros, text + prefixLength, static_cast<size_t>(length) - prefixLength);
+			}
+
+			// Writes [spaces][prefix][zeros][body][spaces] to spec.Width.
+			template<typename Sink>
+			static void Padded(Output<Sink>& out, const Spec& spec, const char* prefix, const size_t prefixLength, const int zeros, const char* body, const size_t length)
+			{
+				const int used = static_cast<int>(prefixLength + length) + zeros;
+				const int padding = spec.Width > used ? spec.Width - used : 0;
+
+				if (!spec.Left)
+					out.pad(' ', padding);
+				out.put(prefix, prefixLength);
+				out.pad('0', zeros);
+				out.put(body, length);
+				if (spec.Left)
+					out.pad(' ', padding);
+			}
+
+			static void LowerCase(char* text, const size_t length)
+			{
+				for (size_t i = 0; i < length; i++)
+				{
+					if (text[i] >= 'A' && text[i] <= 'F')
+						text[i] = static_cast<char>(text[i] - 'A' + 'a');
+				}
+			}
+		};
+	}
+}
+
+// Compile time checked printf() format: Serial.printf(FMT("t=%lu ms\n"), millis());
+#define FMT(format) ([]() { struct Literal : ::ArduinoWindowsHost::Hal::FormatLiteral { static constexpr const char* value() { return format; } }; return Literal{}; }())
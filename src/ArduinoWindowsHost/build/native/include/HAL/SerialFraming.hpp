@@ -0,0 +1,429 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <memory>
+
+#include "ArduinoSerialPort.hpp"
+
+namespace ArduinoWindowsHost
+{
+	namespace Hal
+	{
+		/// <summary>
+		/// A decoded frame, in place in the RX ring: up to two spans, the second after the ring wraps around.
+		/// Valid until the frame is released (SerialFramer::releaseFrame() or the next readFrame()).
+		/// </summary>
+		struct SerialFrame
+		{
+			const uint8_t* First = nullptr;
+			size_t FirstLength = 0;
+			const uint8_t* Second = nullptr;
+			size_t SecondLength = 0;
+
+			size_t size() const
+			{
+				return FirstLength + SecondLength;
+			}
+
+			// True when the frame is a single span (Second is empty).
+			bool contiguous() const
+			{
+				return SecondLength == 0;
+			}
+
+			uint8_t operator[](const size_t index) const
+			{
+				return index < FirstLength ? First[index] : Second[index - FirstLength];
+			}
+
+			// Copies the frame out, returns its size.
+			size_t copyTo(uint8_t* buffer) const
+			{
+				memcpy(buffer, First, FirstLength);
+				if (SecondLength > 0)
+					memcpy(buffer + FirstLength, Second, SecondLength);
+				return size();
+			}
+		};
+
+		// Frame encodings. Decoders work in place over plain pointers and SplitBytes, see SerialFramer.
+		struct SerialFraming
+		{
+			// Bytes split at a ring wrap-around, indexed as one sequence.
+			struct SplitBytes
+			{
+				uint8_t* First;
+				size_t FirstLength;
+				uint8_t* Second;
+
+				uint8_t& operator[](const size_t index) const
+				{
+					return index < FirstLength ? First[index] : Second[index - FirstLength];
+				}
+			};
+
+			/// <summary>
+			/// Consistent Overhead Byte Stuffing: frames hold no 0x00, which ends each frame.
+			/// </summary>
+			struct Cobs
+			{
+				static constexpr uint8_t Delimiter = 0x00;
+
+				// Worst case encoded size, delimiter included.
+				static constexpr size_t MaxEncodedLength(const size_t length)
+				{
+					return length + (length / 254) + 2;
+				}
+
+				// Encodes data and appends the delimiter, returns the encoded length.
+				static size_t Encode(const uint8_t* data, const size_t length, uint8_t* out)
+				{
+					size_t codeIndex = 0;
+					size_t write = 1;
+					uint8_t code = 1;
+					for (size_t i = 0; i < length; i++)
+					{
+						if (data[i] == 0)
+						{
+							out[codeIndex] = code;
+							codeIndex = write++;
+							code = 1;
+						}
+						else
+						{
+							out[write++] = data[i];
+							if (++code == 0xFF)
+							{
+								out[codeIndex] = code;
+								codeIndex = write++;
+								code = 1;
+							}
+						}
+					}
+					out[codeIndex] = code;
+					out[write++] = Delimiter;
+					return write;
+				}
+
+				// Decodes length bytes (delimiter excluded) in place. Returns the decoded length, SIZE_MAX if malformed.
+				template<typename Bytes>
+				static size_t Decode(Bytes bytes, const size_t length)
+				{
+					size_t read = 0;
+					size_t write = 0;
+					while (read < length)
+					{
+						const uint8_t code = bytes[read++];
+						const size_t count = static_cast<size_t>(code) - 1;
+						if (code == 0 || read + count > length)
+							return SIZE_MAX;
+
+						Move(bytes, write, read, count);
+						write += count;
+						read += count;
+						if (code != 0xFF && read < length)
+							bytes[write++] = 0;
+					}
+					return write;
+				}
+			};
+
+			/// <summary>
+			/// Serial Line IP (RFC 1055): END (0xC0) delimits frames, ESC (0xDB) escapes END and ESC in the data.
+			/// Frames are sent with a leading END, so line noise ahead of a frame is flushed as an empty frame.
+			/// </summary>
+			struct Slip
+			{
+				static constexpr uint8_t Delimiter = 0xC0;
+				static constexpr uint8_t Escape = 0xDB;
+				static constexpr uint8_t EscapedEnd = 0xDC;
+				static constexpr uint8_t EscapedEscape = 0xDD;
+
+				// Worst case encoded size, delimiters included.
+				static constexpr size_t MaxEncodedLength(const size_t length)
+				{
+					return (length * 2) + 2;
+				}
+
+				// Encodes data between END delimiters, returns the encoded length.
+				static size_t Encode(const uint8_t* data, const size_t length, uint8_t* out)
+				{
+					size_t write = 0;
+					out[write++] = Delimiter;
+					for (size_t i = 0; i < length; i++)
+					{
+						const uint8_t value = data[i];
+						if (value == Delimiter)
+						{
+							out[write++] = Escape;
+							out[write++] = EscapedEnd;
+						}
+						else if (value == Escape)
+						{
+							out[write++] = Escape;
+							out[write++] = EscapedEscape;
+						}
+						else
+						{
+							out[write++] = value;
+						}
+					}
+					out[write++] = Delimiter;
+					return write;
+				}
+
+				// Decodes length bytes (delimiter excluded) in place. Returns the decoded length, SIZE_MAX if malformed.
+				template<typename Bytes>
+				static size_t Decode(Bytes bytes, const size_t length)
+				{
+					size_t read = 0;
+					size_t write = 0;
+					while (read < length)
+					{
+						// Plain runs move as a block.
+						const size_t run = FindEscape(bytes, read, length) - read;
+						Move(bytes, write, read, run);
+						write += run;
+						read += run;
+						if (read >= length)
+							break;
+
+						if (read + 1 >= length)
+							return SIZE_MAX;
+						const uint8_t escaped = bytes[read + 1];
+						if (escaped == EscapedEnd)
+							bytes[write++] = Delimiter;
+						else if (escaped == EscapedEscape)
+							bytes[write++] = Escape;
+						else
+							return SIZE_MAX;
+						read += 2;
+					}
+					return write;
+				}
+
+			private:
+				static size_t FindEscape(uint8_t* bytes, const size_t from, const size_t length)
+				{
+					const void* found = memchr(bytes + from, Escape, length - from);
+					return found != nullptr ? static_cast<size_t>(static_cast<const uint8_t*>(found) - bytes) : length;
+				}
+
+				static size_t FindEscape(const SplitBytes& bytes, size_t from, const size_t length)
+				{
+					while (from < length && bytes[from] != Escape)
+						from++;
+					return from;
+				}
+			};
+
+		private:
+			// Moves count bytes from index from down to index to (to <= from).
+			static void Move(uint8_t* bytes, const size_t to, const size_t from, const size_t count)
+			{
+				if (to != from)
+					memmove(bytes + to, bytes + from, count);
+			}
+
+			static void Move(const SplitBytes& bytes, const size_t to, const size_t from, const size_t count)
+			{
+				if (to != from)
+				{
+					for (size_t i = 0; i < count; i++)
+						bytes[to + i] = bytes[from + i];
+				}
+			}
+		};
+
+		/// <summary>
+		/// Binary framing over an ArduinoSerialPort, COBS or SLIP.
+		/// - writeFrame() encodes into a scratch buffer and sends the frame in a single write().
+		///   Binary frames belong on the raw TX channel: disable the line log with SetTxLineLog(false).
+		/// - readFrame() finds the next delimiter in the RX ring and decodes the frame in place,
+		///   handing it out as spans with no copy, split across the ring wrap-around if needed.
+		///   Bytes already scanned aren't rescanned while a frame is still arriving.
+		/// - RX calls are for the sketch (reader) thread only, like read().
+		/// </summary>
+		template<typename Encoding>
+		class TemplateSerialFramer
+		{
+		public:
+			static constexpr size_t DefaultMaxFrameLength = 256;
+
+		private:
+			ArduinoSerialPort& Port;
+			const size_t MaxFrameLength;
+			std::unique_ptr<uint8_t[]> TxBuffer;
+
+			// RX bytes held by the current frame (delimiter included), and bytes scanned for a delimiter.
+			size_t Held = 0;
+			size_t Scanned = 0;
+
+			uint32_t FramesRead = 0;
+			uint32_t FrameErrors = 0;
+			uint32_t FrameOverflows = 0;
+
+		public:
+			TemplateSerialFramer(ArduinoSerialPort& port, const size_t maxFrameLength = DefaultMaxFrameLength)
+				: Port(port)
+				, MaxFrameLength(maxFrameLength)
+				, TxBuffer(new uint8_t[Encoding::MaxEncodedLength(maxFrameLength)])
+			{
+			}
+
+			// Encodes and sends a frame of up to MaxFrameLength bytes. Returns length, 0 if too long.
+			size_t writeFrame(const uint8_t* data, const size_t length)
+			{
+				if (length > MaxFrameLength)
+					return 0;
+
+				const size_t encoded = Encoding::Encode(data, length, TxBuffer.get());
+				return Port.write(TxBuffer.get(), encoded) == encoded ? length : 0;
+			}
+
+			size_t writeFrame(const char* data, const size_t length)
+			{
+				return writeFrame(reinterpret_cast<const uint8_t*>(data), length);
+			}
+
+			/// <summary>
+			/// Decodes the next complete frame in place, releasing the previous one.
+			/// Empty frames are skipped; malformed ones are dropped and counted.
+			/// </summary>
+			/// <returns>False if no complete frame has arrived yet.</returns>
+			bool readFrame(SerialFrame& frame)
+			{
+				releaseFrame();
+
+				while (true)
+				{
+					uint8_t* first;
+					uint8_t* second;
+					size_t firstLength, secondLength;
+					const size_t ready = Port.peekRx(first, firstLength, second, secondLength);
+					if (Scanned > ready)
+						Scanned = 0;
+
+					const size_t end = FindDelimiter(first, firstLength, second, secondLength, Scanned);
+					if (end >= ready)
+					{
+						Scanned = ready;
+						if (ready >= Port.GetRxCapacity())
+						{
+							// Ring full without a delimiter: the frame can never complete.
+							FrameOverflows++;
+							Release(ready);
+						}
+						return false;
+					}
+
+					const size_t decoded = end <= firstLength
+						? Encoding::Decode(first, end)
+						: Encoding::Decode(SerialFraming::SplitBytes{ first, firstLength, second }, end);
+
+					if (decoded == SIZE_MAX)
+					{
+						FrameErrors++;
+						Release(end + 1);
+						continue;
+					}
+					if (decoded == 0)
+					{
+						Release(end + 1);
+						continue;
+					}
+
+					frame.First = first;
+					frame.FirstLength = decoded < firstLength ? decoded : firstLength;
+					frame.Second = second;
+					frame.SecondLength = decoded - frame.FirstLength;
+					Held = end + 1;
+					FramesRead++;
+					return true;
+				}
+			}
+
+			// Releases the current frame's RX bytes.
+			void releaseFrame()
+			{
+				if (Held > 0)
+				{
+					Release(Held);
+					Held = 0;
+				}
+			}
+
+			/// <summary>
+			/// Visits every complete frame as visitor(const SerialFrame&), releasing each after the visit.
+			/// </summary>
+			/// <returns>Frames visited.</returns>
+			template<typename F>
+			uint32_t readFrames(F&& visitor)
+			{
+				uint32_t count = 0;
+				SerialFrame frame;
+				while (readFrame(frame))
+				{
+					visitor(static_cast<const SerialFrame&>(frame));
+					count++;
+				}
+				releaseFrame();
+				return count;
+			}
+
+			size_t GetMaxFrameLength() const
+			{
+				return MaxFrameLength;
+			}
+
+			uint32_t GetFramesRead() const
+			{
+				return FramesRead;
+			}
+
+			// Malformed frames dropped.
+			uint32_t GetFrameErrors() const
+			{
+				return FrameErrors;
+			}
+
+			// Unterminated data dropped because it filled the RX ring.
+			uint32_t GetFrameOverflows() const
+			{
+				return FrameOverflows;
+			}
+
+		private:
+			void Release(const size_t count)
+			{
+				Port.consumeRx(count);
+				Scanned = 0;
+			}
+
+			// Index of the first delimiter at or after from, the total length if none.
+			static size_t FindDelimiter(const uint8_t* first, const size_t firstLength, const uint8_t* second, const size_t secondLength, const size_t from)
+			{
+				if (from < firstLength)
+				{
+					const void* found = memchr(first + from, Encoding::Delimiter, firstLength - from);
+					if (found != nullptr)
+						return static_cast<size_t>(static_cast<const uint8_t*>(found) - first);
+				}
+
+				const size_t secondFrom = from > firstLength ? from - firstLength : 0;
+				if (secondFrom < secondLength)
+				{
+					const void* found = memchr(second + secondFrom, Encoding::Delimiter, secondLength - secondFrom);
+					if (found != nullptr)
+						return firstLength + static_cast<size_t>(static_cast<const uint8_t*>(found) - second);
+				}
+				return firstLength + secondLength;
+			}
+		};
+
+		using CobsSerialFramer = TemplateSerialFramer<SerialFraming::Cobs>;
+		using SlipSerialFramer = TemplateSerialFramer<SerialFraming::Slip>;
+	}
+}
@@ -0,0 +1,257 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <memory>
+
+namespace ArduinoWindowsHost
+{
+	namespace Hal
+	{
+		/// <summary>
+		/// Serial TX line log: a contiguous byte arena plus a compact line index.
+		/// - Line text is stored back to back in the arena, each line contiguous (never split by the wrap).
+		///   A line that doesn't fit before the arena end starts over at offset 0.
+		/// - The index is a ring of {start, length} entries, oldest first.
+		/// - Oldest lines are evicted when the arena byte budget or the index runs out.
+		/// - The open (not yet terminated) line is assembled in place, so committing a line copies nothing.
+		/// - Lines longer than the whole arena are split.
+		/// - Every committed line gets a sequence number, so readers can resume from a cursor,
+		///   and keeps the timestamp and loop iteration given to commit() in its index entry.
+		///   clear() skips a sequence number, so cursors taken before it always report missed lines.
+		/// Not thread safe, the owner serializes access. Allocates only on construction.
+		/// </summary>
+		class SerialLineLog
+		{
+		public:
+			// Line metadata, as stored in the index.
+			struct LineInfo
+			{
+				uint64_t Sequence;
+				uint64_t Timestamp;
+				uint32_t Iteration;
+			};
+
+		private:
+			// Arena positions are free-running 32 bit counters, masked on access.
+			struct LineEntry
+			{
+				uint32_t Start;
+				uint32_t Length;
+				uint32_t Iteration;
+				uint64_t Timestamp;
+			};
+
+		private:
+			std::unique_ptr<char[]> Arena;
+			std::unique_ptr<LineEntry[]> Index;
+
+			const uint32_t ByteCapacity;
+			const uint32_t ByteMask;
+			const size_t IndexCapacity;
+
+			size_t IndexHead = 0;	// Next index slot to write.
+			size_t LineCount = 0;	// Committed lines.
+
+			uint32_t OpenStart = 0;	// Arena position of the open line.
+			uint32_t OpenLength = 0;
+
+			uint64_t NextSequence = 0; // Sequence of the next committed line.
+
+		public:
+			// byteCapacity is rounded up to a power of 2.
+			SerialLineLog(const size_t lineCapacity, const size_t byteCapacity)
+				: Arena(new char[RoundCapacity(byteCapacity)])
+				, Index(new LineEntry[lineCapacity > 0 ? lineCapacity : 1])
+				, ByteCapacity(RoundCapacity(byteCapacity))
+				, ByteMask(RoundCapacity(byteCapacity) - 1)
+				, IndexCapacity(lineCapacity > 0 ? lineCapacity : 1)
+			{
+			}
+
+			SerialLineLog(const SerialLineLog&) = delete;
+			SerialLineLog& operator=(const SerialLineLog&) = delete;
+
+			// Number of committed lines.
+			size_t size() const
+			{
+				return LineCount;
+			}
+
+			size_t lineCapacity() const
+			{
+				return IndexCapacity;
+			}
+
+			size_t byteCapacity() const
+			{
+				return ByteCapacity;
+			}
+
+			// Length of the open line.
+			size_t pending() const
+			{
+				return OpenLength;
+			}
+
+			// Sequence the next committed line will get.
+			uint64_t nextSequence() const
+			{
+				return NextSequence;
+			}
+
+			// Sequence of the oldest line still stored (== nextSequence() when empty).
+			uint64_t oldestSequence() const
+			{
+				return NextSequence - LineCount;
+			}
+
+			// Drops all lines, including the open one.
+			void clear()
+			{
+				LineCount = 0;
+				OpenLength = 0;
+				NextSequence++;
+			}
+
+			// Appends text to the open line.
+			void append(const char* data, size_t length)
+			{
+				while (length > 0)
+				{
+					const uint32_t room = ByteCapacity - OpenLength;
+					if (room == 0)
+					{
+						// Line as long as the arena, split it.
+						commit();
+						continue;
+					}
+
+					const uint32_t chunk = length < room ? static_cast<uint32_t>(length) : room;
+					reserve(OpenLength + chunk);
+					memcpy(&Arena[(OpenStart & ByteMask) + OpenLength], data, chunk);
+					OpenLength += chunk;
+					data += chunk;
+					length -= chunk;
+				}
+			}
+
+			void append(const char value)
+			{
+				append(&value, 1);
+			}
+
+			// Terminates the open line, moving it into the index.
+			// Lines split by append() for being longer than the arena get a zero timestamp and iteration.
+			void commit(const uint64_t timestamp = 0, const uint32_t iteration = 0)
+			{
+				if (LineCount == IndexCapacity)
+					evictOldest();
+
+				Index[IndexHead].Start = OpenStart;
+				Index[IndexHead].Length = OpenLength;
+				Index[IndexHead].Iteration = iteration;
+				Index[IndexHead].Timestamp = timestamp;
+				IndexHead = (IndexHead + 1) % IndexCapacity;
+				LineCount++;
+				NextSequence++;
+
+				OpenStart += OpenLength;
+				OpenLength = 0;
+			}
+
+			// Visits committed lines oldest first, as f(const char* data, size_t length).
+			template<typename F>
+			void forEach(F&& f) const
+			{
+				size_t slot = (IndexHead + IndexCapacity - LineCount) % IndexCapacity;
+				for (size_t i = 0; i < LineCount; i++)
+				{
+					const LineEntry& entry = Index[slot];
+					f(&Arena[entry.Start & ByteMask], static_cast<size_t>(entry.Length));
+					slot = (slot + 1) % IndexCapacity;
+				}
+			}
+
+			// Visits up to maxLines committed lines starting at sequence, as f(uint64_t sequence, const char* data, size_t length).
+			// Lines older than the oldest stored are skipped, missed reports whether any were.
+			// Returns the sequence following the last line visited.
+			template<typename F>
+			uint64_t forEachFrom(const uint64_t sequence, F&& f, bool& missed, const size_t maxLines = SIZE_MAX) const
+			{
+				return forEachInfoFrom(sequence, [&f](const LineInfo& info, const char* data, const size_t length)
+					{
+						f(info.Sequence, data, length);
+					}, missed, maxLines);
+			}
+
+			// As forEachFrom(), visiting f(const LineInfo& info, const char* data, size_t length).
+			template<typename F>
+			uint64_t forEachInfoFrom(uint64_t sequence, F&& f, bool& missed, const size_t maxLines = SIZE_MAX) const
+			{
+				const uint64_t oldest = oldestSequence();
+				missed = sequence < oldest || sequence > NextSequence;
+				if (sequence < oldest)
+					sequence = oldest;
+				else if (sequence > NextSequence)
+					sequence = NextSequence;
+
+				const size_t count = static_cast<size_t>(NextSequence - sequence) < maxLines ? static_cast<size_t>(NextSequence - sequence) : maxLines;
+				size_t slot = (IndexHead + IndexCapacity - static_cast<size_t>(NextSequence - sequence)) % IndexCapacity;
+				for (size_t i = 0; i < count; i++)
+				{
+					const LineEntry& entry = Index[slot];
+					const LineInfo info{ sequence, entry.Timestamp, entry.Iteration };
+					f(info, &Arena[entry.Start & ByteMask], static_cast<size_t>(entry.Length));
+					slot = (slot + 1) % IndexCapacity;
+					sequence++;
+				}
+
+				return sequence;
+			}
+
+		private:
+			// Makes room for the open line to be length bytes long, relocating it to the arena start if it would cross the end.
+			void reserve(const uint32_t length)
+			{
+				uint32_t start = OpenStart;
+				if ((start & ByteMask) + length > ByteCapacity)
+				{
+					// Skip the arena tail.
+					start = (start + ByteCapacity) & ~ByteMask;
+				}
+
+				while (LineCount > 0 && (start + length - oldestStart()) > ByteCapacity)
+				{
+					evictOldest();
+				}
+
+				if (start != OpenStart)
+				{
+					if (OpenLength > 0)
+						memmove(&Arena[0], &Arena[OpenStart & ByteMask], OpenLength);
+					OpenStart = start;
+				}
+			}
+
+			uint32_t oldestStart() const
+			{
+				return Index[(IndexHead + IndexCapacity - LineCount) % IndexCapacity].Start;
+			}
+
+			void evictOldest()
+			{
+				LineCount--;
+			}
+
+			static uint32_t RoundCapacity(const size_t capacity)
+			{
+				uint32_t rounded = 1;
+				while (rounded < capacity && rounded < (UINT32_C(1) << 31))
+					rounded <<= 1;
+				return rounded;
+			}
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,260 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+namespace ArduinoWindowsHost
+{
+	namespace Hal
+	{
+		// Serial timing model mode.
+		enum class SerialTiming : uint8_t
+		{
+			Off,		// Writes and Rx() complete instantly (default).
+			Measure,	// TX blocking is accounted, as if the sketch had waited, but nothing waits.
+			Block		// Writes block while the TX FIFO is full; Rx() delivers at the line rate.
+		};
+
+		/// <summary>
+		/// Baud rate model of a UART, as HardwareSerial on the target: a TX FIFO drained at the line rate,
+		/// a writer blocked until its bytes fit, and an RX line delivering no faster than the line rate.
+		/// - The FIFO is tracked as the time it drains empty, so metering a write is a few arithmetic operations.
+		/// - Measure mode runs the model on a virtual clock that includes the blocking it accounted,
+		///   so later writes see the FIFO as the target would after waiting.
+		/// - Waits sleep until close to the deadline, then spin (OS sleep granularity is coarse).
+		/// </summary>
+		class SerialTimingModel
+		{
+		public:
+			static constexpr size_t DefaultTxFifo = 64;		// AVR HardwareSerial TX buffer.
+			static constexpr uint8_t DefaultFrameBits = 10;	// 8N1.
+
+			struct Statistics
+			{
+				uint64_t TxBytes;
+				uint64_t TxBlockedMicros;	// Time writers spent (or would have spent) waiting for FIFO space.
+				uint32_t TxBlockedWrites;	// Writes that found the FIFO too full.
+				uint64_t RxThrottledMicros;	// Time Rx() callers waited for the line.
+			};
+
+		private:
+			using Clock = std::chrono::steady_clock;
+
+			static constexpr int64_t SpinThresholdNanos = 2000000;
+
+		private:
+			std::mutex Mutex{};
+			std::atomic<bool> Active{ false };
+
+			SerialTiming Mode = SerialTiming::Off;
+			uint32_t BaudRate = 0;
+			size_t TxFifo = DefaultTxFifo;
+			uint8_t FrameBits = DefaultFrameBits;
+			int64_t ByteNanos = 0;
+
+			// Model clock: when the TX FIFO drains empty, when the RX line is next free,
+			// and (Measure) blocking accounted but not waited.
+			int64_t TxDrainEnd = 0;
+			int64_t RxLineFree = 0;
+			int64_t VirtualNanos = 0;
+
+			std::atomic<uint64_t> TxBytes{ 0 };
+			std::atomic<uint64_t> TxBlockedNanos{ 0 };
+			std::atomic<uint32_t> TxBlockedWrites{ 0 };
+			std::atomic<uint64_t> RxThrottledNanos{ 0 };
+
+		public:
+			void SetMode(const SerialTiming mode, const size_t txFifo, const uint8_t frameBits)
+			{
+				std::lock_guard<std::mutex> lock(Mutex);
+				Mode = mode;
+				TxFifo = txFifo > 0 ? txFifo : 1;
+				FrameBits = frameBits > 0 ? frameBits : DefaultFrameBits;
+				UpdateLocked();
+			}
+
+			void SetBaudRate(const uint32_t baudRate)
+			{
+				std::lock_guard<std::mutex> lock(Mutex);
+				BaudRate = baudRate;
+				UpdateLocked();
+			}
+
+			SerialTiming GetMode() const
+			{
+				return Mode;
+			}
+
+			uint32_t GetBaudRate() const
+			{
+				return BaudRate;
+			}
+
+			size_t GetTxFifo() const
+			{
+				return TxFifo;
+			}
+
+			// Largest chunk Receive() meters at once, a FIFO's worth in Block mode (unlimited otherwise),
+			// so a long chunk arrives as a trickle of slices rather than one late burst.
+			size_t GetRxSlice() const
+			{
+				return Mode == SerialTiming::Block ? TxFifo : SIZE_MAX;
+			}
+
+			// True when a mode is set and a baud rate is known.
+			bool IsActive() const
+			{
+				return Active.load(std::memory_order_relaxed);
+			}
+
+			// Puts size bytes in the TX FIFO, blocking (or accounting) until the last of them fits.
+			void Transmit(const size_t size)
+			{
+				int64_t deadline;
+				{
+					std::lock_guard<std::mutex> lock(Mutex);
+					if (!Active.load(std::memory_order_relaxed))
+						return;
+
+					const int64_t now = NowLocked();
+					const int64_t start = TxDrainEnd > now ? TxDrainEnd : now;
+					TxDrainEnd = start + static_cast<int64_t>(size) * ByteNanos;
+					TxBytes.fetch_add(size, std::memory_order_relaxed);
+
+					// The write returns once no more than a FIFO's worth is left to send.
+					deadline = TxDrainEnd - static_cast<int64_t>(TxFifo) * ByteNanos;
+					if (deadline <= now)
+						return;
+
+					TxBlockedNanos.fetch_add(static_cast<uint64_t>(deadline - now), std::memory_order_relaxed);
+					TxBlockedWrites.fetch_add(1, std::memory_order_relaxed);
+					if (Mode == SerialTiming::Measure)
+					{
+						VirtualNanos += deadline - now;
+						return;
+					}
+				}
+				WaitUntil(deadline);
+			}
+
+			// Free TX FIFO space now.
+			size_t AvailableForWrite()
+			{
+				std::lock_guard<std::mutex> lock(Mutex);
+				if (!Active.load(std::memory_order_relaxed))
+					return TxFifo;
+
+				const size_t pending = PendingLocked(NowLocked());
+				return pending < TxFifo ? TxFifo - pending : 0;
+			}
+
+			// Waits (Block) or accounts (Measure) until the TX FIFO has drained.
+			void Drain()
+			{
+				int64_t deadline;
+				{
+					std::lock_guard<std::mutex> lock(Mutex);
+					if (!Active.load(std::memory_order_relaxed))
+						return;
+
+					const int64_t now = NowLocked();
+					deadline = TxDrainEnd;
+					if (deadline <= now)
+						return;
+
+					TxBlockedNanos.fetch_add(static_cast<uint64_t>(deadline - now), std::memory_order_relaxed);
+					if (Mode == SerialTiming::Measure)
+					{
+						VirtualNanos += deadline - now;
+						return;
+					}
+				}
+				WaitUntil(deadline);
+			}
+
+			// Block mode: waits until size bytes have arrived over the line, after those before them.
+			void Receive(const size_t size)
+			{
+				int64_t deadline;
+				{
+					std::lock_guard<std::mutex> lock(Mutex);
+					if (!Active.load(std::memory_order_relaxed) || Mode != SerialTiming::Block)
+						return;
+
+					const int64_t now = Now();
+					const int64_t start = RxLineFree > now ? RxLineFree : now;
+					RxLineFree = start + static_cast<int64_t>(size) * ByteNanos;
+					deadline = RxLineFree;
+				}
+				const int64_t remaining = deadline - Now();
+				if (remaining > 0)
+				{
+					RxThrottledNanos.fetch_add(static_cast<uint64_t>(remaining), std::memory_order_relaxed);
+					WaitUntil(deadline);
+				}
+			}
+
+			Statistics GetStatistics() const
+			{
+				Statistics statistics;
+				statistics.TxBytes = TxBytes.load(std::memory_order_relaxed);
+				statistics.TxBlockedMicros = TxBlockedNanos.load(std::memory_order_relaxed) / 1000;
+				statistics.TxBlockedWrites = TxBlockedWrites.load(std::memory_order_relaxed);
+				statistics.RxThrottledMicros = RxThrottledNanos.load(std::memory_order_relaxed) / 1000;
+				return statistics;
+			}
+
+			void ResetStatistics()
+			{
+				TxBytes.store(0, std::memory_order_relaxed);
+				TxBlockedNanos.store(0, std::memory_order_relaxed);
+				TxBlockedWrites.store(0, std::memory_order_relaxed);
+				RxThrottledNanos.store(0, std::memory_order_relaxed);
+			}
+
+		private:
+			void UpdateLocked()
+			{
+				ByteNanos = BaudRate > 0 ? (static_cast<int64_t>(FrameBits) * 1000000000LL) / BaudRate : 0;
+				TxDrainEnd = 0;
+				RxLineFree = 0;
+				VirtualNanos = 0;
+				Active.store(Mode != SerialTiming::Off && ByteNanos > 0, std::memory_order_relaxed);
+			}
+
+			// Model time: real time, plus the blocking Measure mode accounted instead of waiting.
+			int64_t NowLocked() const
+			{
+				return Now() + VirtualNanos;
+			}
+
+			// Bytes still in the TX FIFO at model time now.
+			size_t PendingLocked(const int64_t now) const
+			{
+				if (TxDrainEnd <= now)
+					return 0;
+				return static_cast<size_t>((TxDrainEnd - now + ByteNanos - 1) / ByteNanos);
+			}
+
+			static int64_t Now()
+			{
+				return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+			}
+
+			static void WaitUntil(const int64_t deadline)
+			{
+				const int64_t remaining = deadline - Now();
+				if (remaining > SpinThresholdNanos)
+					std::this_thread::sleep_for(std::chrono::nanoseconds(remaining - SpinThresholdNanos));
+
+				while (Now() < deadline)
+					std::this_thread::yield();
+			}
+		};
+	}
+}
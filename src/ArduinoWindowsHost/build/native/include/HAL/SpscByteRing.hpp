@@ -0,0 +1,255 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <atomic>
+#include <memory>
+
+namespace ArduinoWindowsHost
+{
+	namespace Hal
+	{
+		/// <summary>
+		/// Lock-free single-producer/single-consumer byte ring.
+		/// - Capacity is rounded up to a power of 2; indices run free and are masked on access.
+		/// - Producer and consumer indices live on separate cache lines, each side
+		///   keeping a cached copy of the other's index to avoid cross-core traffic.
+		/// - Producer calls: write(), freeSpace().
+		/// - Consumer calls: available(), peek(), read(), readUntil(), peekSpan(), peekSpans(), consume(), clear().
+		/// </summary>
+		class SpscByteRing
+		{
+		private:
+			static constexpr size_t CacheLineSize = 64;
+
+		private:
+			std::unique_ptr<uint8_t[]> Buffer;
+			const size_t Capacity;
+			const size_t Mask;
+
+			uint8_t PadHead[CacheLineSize]{};
+
+			// Producer side.
+			std::atomic<size_t> Head{ 0 };
+			mutable size_t CachedTail = 0;
+
+			uint8_t PadTail[CacheLineSize]{};
+
+			// Consumer side.
+			std::atomic<size_t> Tail{ 0 };
+			mutable size_t CachedHead = 0;
+
+			uint8_t PadEnd[CacheLineSize]{};
+
+		public:
+			SpscByteRing(const size_t capacity)
+				: Buffer(new uint8_t[RoundCapacity(capacity)]{})
+				, Capacity(RoundCapacity(capacity))
+				, Mask(RoundCapacity(capacity) - 1)
+			{
+			}
+
+			SpscByteRing(const SpscByteRing&) = delete;
+			SpscByteRing& operator=(const SpscByteRing&) = delete;
+
+			size_t capacity() const
+			{
+				return Capacity;
+			}
+
+		public:
+			// Producer: bytes that can be written without overwriting unread data.
+			size_t freeSpace() const
+			{
+				const size_t head = Head.load(std::memory_order_relaxed);
+				CachedTail = Tail.load(std::memory_order_acquire);
+				return Capacity - (head - CachedTail);
+			}
+
+			// Producer: copies up to length bytes in, returns bytes accepted.
+			size_t write(const uint8_t* data, const size_t length)
+			{
+				const size_t head = Head.load(std::memory_order_relaxed);
+				size_t space = Capacity - (head - CachedTail);
+				if (space < length)
+				{
+					CachedTail = Tail.load(std::memory_order_acquire);
+					space = Capacity - (head - CachedTail);
+				}
+
+				const size_t count = length < space ? length : space;
+				if (count == 0)
+					return 0;
+
+				const size_t offset = head & Mask;
+				const size_t first = (Capacity - offset) < count ? (Capacity - offset) : count;
+				memcpy(&Buffer[offset], data, first);
+				if (count > first)
+					memcpy(&Buffer[0], data + first, count - first);
+
+				Head.store(head + count, std::memory_order_release);
+
+				return count;
+			}
+
+		public:
+			// Consumer: bytes ready to read.
+			size_t available() const
+			{
+				CachedHead = Head.load(std::memory_order_acquire);
+				return CachedHead - Tail.load(std::memory_order_relaxed);
+			}
+
+			// Consumer: next byte without removing it, -1 if empty.
+			int peek() const
+			{
+				const size_t tail = Tail.load(std::memory_order_relaxed);
+				if (tail == CachedHead)
+				{
+					CachedHead = Head.load(std::memory_order_acquire);
+					if (tail == CachedHead)
+						return -1;
+				}
+				return Buffer[tail & Mask];
+			}
+
+			// Consumer: next byte, -1 if empty.
+			int read()
+			{
+				const size_t tail = Tail.load(std::memory_order_relaxed);
+				if (tail == CachedHead)
+				{
+					CachedHead = Head.load(std::memory_order_acquire);
+					if (tail == CachedHead)
+						return -1;
+				}
+				const uint8_t value = Buffer[tail & Mask];
+				Tail.store(tail + 1, std::memory_order_release);
+				return value;
+			}
+
+			// Consumer: copies up to length bytes out, returns bytes read.
+			size_t read(uint8_t* data, const size_t length)
+			{
+				const size_t tail = Tail.load(std::memory_order_relaxed);
+				if (CachedHead - tail < length)
+					CachedHead = Head.load(std::memory_order_acquire);
+
+				const size_t ready = CachedHead - tail;
+				const size_t count = length < ready ? length : ready;
+				if (count == 0)
+					return 0;
+
+				copyOut(tail, data, count);
+				Tail.store(tail + count, std::memory_order_release);
+
+				return count;
+			}
+
+			// Consumer: copies bytes out up to (not including) terminator, which is consumed but not copied.
+			// Stops at length bytes or when the ring is empty. terminated reports whether the terminator was found.
+			size_t readUntil(const uint8_t terminator, uint8_t* data, const size_t length, bool& terminated)
+			{
+				terminated = false;
+
+				const size_t tail = Tail.load(std::memory_order_relaxed);
+				CachedHead = Head.load(std::memory_order_acquire);
+
+				const size_t ready = CachedHead - tail;
+				const size_t scan = length < ready ? length : ready;
+
+				// Search the (up to) two contiguous segments.
+				size_t count = scan;
+				size_t consumed = scan;
+				const size_t offset = tail & Mask;
+				const size_t first = (Capacity - offset) < scan ? (Capacity - offset) : scan;
+				const void* found = memchr(&Buffer[offset], terminator, first);
+				if (found != nullptr)
+				{
+					count = static_cast<size_t>(static_cast<const uint8_t*>(found) - &Buffer[offset]);
+				}
+				else if (scan > first)
+				{
+					found = memchr(&Buffer[0], terminator, scan - first);
+					if (found != nullptr)
+						count = first + static_cast<size_t>(static_cast<const uint8_t*>(found) - &Buffer[0]);
+				}
+
+				if (found != nullptr)
+				{
+					terminated = true;
+					consumed = count + 1;
+				}
+
+				copyOut(tail, data, count);
+				if (consumed > 0)
+					Tail.store(tail + consumed, std::memory_order_release);
+
+				return count;
+			}
+
+			// Consumer: zero-copy access to the first contiguous readable segment, returns its length.
+			// The bytes stay in the ring until consume(); a wrapped ring takes two spans.
+			size_t peekSpan(const uint8_t*& data) const
+			{
+				const size_t tail = Tail.load(std::memory_order_relaxed);
+				CachedHead = Head.load(std::memory_order_acquire);
+
+				const size_t ready = CachedHead - tail;
+				const size_t offset = tail & Mask;
+				data = &Buffer[offset];
+				return (Capacity - offset) < ready ? (Capacity - offset) : ready;
+			}
+
+			// Consumer: all readable bytes as two spans, the second starting at the ring's wrap-around (empty if none).
+			// The consumer owns them until consume() and may modify them in place. Returns the total length.
+			size_t peekSpans(uint8_t*& first, size_t& firstLength, uint8_t*& second, size_t& secondLength)
+			{
+				const size_t tail = Tail.load(std::memory_order_relaxed);
+				CachedHead = Head.load(std::memory_order_acquire);
+
+				const size_t ready = CachedHead - tail;
+				const size_t offset = tail & Mask;
+				first = &Buffer[offset];
+				firstLength = (Capacity - offset) < ready ? (Capacity - offset) : ready;
+				second = &Buffer[0];
+				secondLength = ready - firstLength;
+				return ready;
+			}
+
+			// Consumer: releases count bytes (up to the last peekSpan()/available()) back to the producer.
+			void consume(const size_t count)
+			{
+				const size_t tail = Tail.load(std::memory_order_relaxed);
+				const size_t ready = CachedHead - tail;
+				Tail.store(tail + (count < ready ? count : ready), std::memory_order_release);
+			}
+
+			// Consumer: drops all readable bytes.
+			void clear()
+			{
+				CachedHead = Head.load(std::memory_order_acquire);
+				Tail.store(CachedHead, std::memory_order_release);
+			}
+
+		private:
+			void copyOut(const size_t tail, uint8_t* data, const size_t count) const
+			{
+				const size_t offset = tail & Mask;
+				const size_t first = (Capacity - offset) < count ? (Capacity - offset) : count;
+				memcpy(data, &Buffer[offset], first);
+				if (count > first)
+					memcpy(data + first, &Buffer[0], count - first);
+			}
+
+			static size_t RoundCapacity(const size_t capacity)
+			{
+				size_t rounded = 1;
+				while (rounded < capacity)
+					rounded <<= 1;
+				return rounded;
+			}
+		};
+	}
+}
\ No newline at end of file
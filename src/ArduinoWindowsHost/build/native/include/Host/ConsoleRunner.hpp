@@ -0,0 +1,398 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <memory>
+#include <thread>
+
+#if !defined(_WIN32)
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+#include "LoopHost.hpp"
+
+namespace ArduinoWindowsHost
+{
+	// Console runner options, see TemplateConsoleRunner::ParseArguments() for the command line.
+	struct ConsoleRunnerConfig
+	{
+		// Stop after this long (ms), 0 to run until the sketch stops, input ends (ExitOnEof) or Ctrl+C.
+		uint32_t DurationMillis = 0;
+
+		// Stop after this many loop() passes, 0 for no limit.
+		uint32_t MaxIterations = 0;
+
+		// Feed stdin to Serial RX, with backpressure so piped input isn't dropped.
+		bool Input = true;
+
+		// Stop once stdin is exhausted and the sketch has read all of it (or stopped reading).
+		bool ExitOnEof = false;
+
+		// Print loop and serial statistics to stderr on exit.
+		bool Statistics = true;
+
+		// stdout buffer size; output is flushed whenever the sketch goes quiet.
+		size_t OutputBufferSize = 64 * 1024;
+	};
+
+	/// <summary>
+	/// Runs a LoopHost sketch headless: Serial TX streams to stdout, stdin streams to Serial RX.
+	/// - The host runs on its own thread, as under TemplateHostManager.
+	/// - Output is read from Serial's raw TX channel in spans and written with buffered stdio,
+	///   flushed once per burst rather than per line. The TX line log is disabled, nothing reads it.
+	/// - Statistics go to stderr, so stdout carries only the sketch's output.
+	/// </summary>
+	template<typename HostType>
+	class TemplateConsoleRunner
+	{
+	public:
+		struct LoopStatistics
+		{
+			uint32_t Iterations;
+			uint32_t ElapsedMillis;
+			uint32_t LoopMinMicros;
+			uint32_t LoopMaxMicros;
+			uint32_t LoopAverageMicros;
+		};
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		// Longest wait between checks of the stop conditions, bounds exit latency.
+		static constexpr uint32_t PollMillis = 10;
+
+		// With ExitOnEof, input left unread this long after EOF counts as abandoned.
+		static constexpr uint32_t EofIdleMillis = 100;
+
+		static constexpr size_t InputChunkSize = 4096;
+
+		// Sketch with loop() timing and the iteration limit, enforced on the loop thread so it's exact.
+		class RunnerHost : public HostType
+		{
+		public:
+			uint32_t MaxIterations = 0;
+			uint32_t Iterations = 0;
+			int64_t LoopMinNanos = INT64_MAX;
+			int64_t LoopMaxNanos = 0;
+			int64_t LoopTotalNanos = 0;
+
+		protected:
+			void loop() override
+			{
+				const Clock::time_point start = Clock::now();
+				HostType::loop();
+				const int64_t duration = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+
+				if (duration < LoopMinNanos)
+					LoopMinNanos = duration;
+				if (duration > LoopMaxNanos)
+					LoopMaxNanos = duration;
+				LoopTotalNanos += duration;
+
+				if (++Iterations == MaxIterations)
+					this->OnStop();
+			}
+		};
+
+	private:
+		// The host's board, owned here so its ports outlive the host for the final drain and statistics.
+		Hal::TemplateHalContext<typename HostType::BoardProfile> Board{};
+
+		std::unique_ptr<char[]> OutputBuffer{};
+		std::atomic<bool> OutputRunning{ false };
+		std::atomic<bool> InputEnded{ false };
+		uint64_t BytesOut = 0;
+		uint64_t BytesIn = 0;
+
+	public:
+		/// <summary>
+		/// Parses runner options, leaving unknown arguments alone.
+		///   -d, --duration MS      Stop after MS milliseconds.
+		///   -n, --iterations N     Stop after N loop() passes.
+		///   --no-input             Don't read stdin.
+		///   --exit-on-eof          Stop once stdin has been consumed.
+		///   -q, --quiet            No statistics on exit.
+		/// </summary>
+		/// <returns>False on a malformed option, after printing usage to stderr.</returns>
+		static bool ParseArguments(const int argc, char** argv, ConsoleRunnerConfig& config)
+		{
+			for (int i = 1; i < argc; i++)
+			{
+				const char* argument = argv[i];
+				if (!strcmp(argument, "-d") || !strcmp(argument, "--duration"))
+				{
+					if (!ParseNumber(argc, argv, i, config.DurationMillis))
+						return Usage(argv[0]);
+				}
+				else if (!strcmp(argument, "-n") || !strcmp(argument, "--iterations"))
+				{
+					if (!ParseNumber(argc, argv, i, config.MaxIterations))
+						return Usage(argv[0]);
+				}
+				else if (!strcmp(argument, "--no-input"))
+				{
+					config.Input = false;
+				}
+				else if (!strcmp(argument, "--exit-on-eof"))
+				{
+					config.ExitOnEof = true;
+				}
+				else if (!strcmp(argument, "-q") || !strcmp(argument, "--quiet"))
+				{
+					config.Statistics = false;
+				}
+				else if (!strcmp(argument, "-h") || !strcmp(argument, "--help"))
+				{
+					return Usage(argv[0]);
+				}
+			}
+			return true;
+		}
+
+		/// <summary>
+		/// Runs a new HostType until a stop condition, then drains its output.
+		/// </summary>
+		/// <returns>Process exit code, 0 unless the host failed to start.</returns>
+		int Run(const ConsoleRunnerConfig& config = ConsoleRunnerConfig())
+		{
+			OutputBuffer.reset(new char[config.OutputBufferSize]);
+			setvbuf(stdout, OutputBuffer.get(), _IOFBF, config.OutputBufferSize);
+
+			Interrupted().store(false);
+			std::signal(SIGINT, OnSignal);
+#if defined(SIGTERM)
+			std::signal(SIGTERM, OnSignal);
+#endif
+
+			Board.Uart0.EnableTxRaw();
+			Board.Uart0.SetTxLineLog(false);
+			if (config.Input)
+				Board.Uart0.SetRxBackpressure(true);
+
+			std::unique_ptr<RunnerHost> host(new RunnerHost());
+			host->MaxIterations = config.MaxIterations;
+			host->SetHal(Board);
+
+			OutputRunning = true;
+			InputEnded = !config.Input;
+			std::thread outputThread(&TemplateConsoleRunner::PumpOutput, this);
+			std::thread inputThread;
+			if (config.Input)
+				inputThread = std::thread(&TemplateConsoleRunner::PumpInput, this);
+
+			const Clock::time_point start = Clock::now();
+			host->OnStart();
+			std::thread hostThread(&LoopHost::OnRun, host.get());
+
+			int unread = -1;
+			uint32_t unreadSince = 0;
+			while (host->isRunning() && !Interrupted().load())
+			{
+				const uint32_t elapsed = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count());
+				if (config.DurationMillis > 0 && elapsed >= config.DurationMillis)
+					break;
+
+				if (config.ExitOnEof && InputEnded.load())
+				{
+					// Unread bytes, from the producer side: the sketch is the RX ring's only consumer.
+					const int available = static_cast<int>(Board.Uart0.GetRxCapacity() - Board.Uart0.GetRxFree());
+					if (available == 0)
+						break;
+					if (available != unread)
+					{
+						unread = available;
+						unreadSince = elapsed;
+					}
+					else if (elapsed - unreadSince >= EofIdleMillis)
+						break;
+				}
+
+				std::this_thread::sleep_for(std::chrono::milliseconds(PollMillis));
+			}
+
+			host->OnStop();
+			hostThread.join();
+			const uint32_t elapsedMillis = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count());
+
+			OutputRunning = false;
+			outputThread.join();
+			fflush(stdout);
+
+			if (inputThread.joinable())
+			{
+#if defined(_WIN32)
+				// A blocking console read can't be cancelled, the process exit ends it.
+				inputThread.detach();
+#else
+				inputThread.join();
+#endif
+			}
+
+			std::signal(SIGINT, SIG_DFL);
+#if defined(SIGTERM)
+			std::signal(SIGTERM, SIG_DFL);
+#endif
+
+			if (config.Statistics)
+				PrintStatistics(GetLoopStatistics(*host, elapsedMillis));
+
+			return 0;
+		}
+
+		// Bytes written to stdout.
+		uint64_t GetBytesOut() const
+		{
+			return BytesOut;
+		}
+
+		// Bytes read from stdin into Serial.
+		uint64_t GetBytesIn() const
+		{
+			return BytesIn;
+		}
+
+	private:
+		static LoopStatistics GetLoopStatistics(const RunnerHost& host, const uint32_t elapsedMillis)
+		{
+			LoopStatistics statistics{};
+			statistics.Iterations = host.Iterations;
+			statistics.ElapsedMillis = elapsedMillis;
+			if (host.Iterations > 0)
+			{
+				statistics.LoopMinMicros = static_cast<uint32_t>(host.LoopMinNanos / 1000);
+				statistics.LoopMaxMicros = static_cast<uint32_t>(host.LoopMaxNanos / 1000);
+				statistics.LoopAverageMicros = static_cast<uint32_t>(host.LoopTotalNanos / host.Iterations / 1000);
+			}
+			return statistics;
+		}
+
+		void PrintStatistics(const LoopStatistics& loop) const
+		{
+			const double seconds = loop.ElapsedMillis > 0 ? loop.ElapsedMillis / 1000.0 : 0.001;
+			fprintf(stderr, "--- %u loops in %u ms (%.0f loops/s), loop() min/avg/max %u/%u/%u us\n",
+				loop.Iterations, loop.ElapsedMillis, loop.Iterations / seconds,
+				loop.LoopMinMicros, loop.LoopAverageMicros, loop.LoopMaxMicros);
+			fprintf(stderr, "--- Serial TX %llu bytes (%.1f KB/s, %u dropped), RX %llu bytes (%u dropped)\n",
+				static_cast<unsigned long long>(BytesOut), (BytesOut / 1024.0) / seconds, Board.Uart0.GetTxRawDropped(),
+				static_cast<unsigned long long>(BytesIn), Board.Uart0.GetRxDropped());
+
+			if (Board.Uart0.GetTiming() != SerialTiming::Off)
+			{
+				const SerialTimingModel::Statistics timing = Board.Uart0.GetTimingStatistics();
+				fprintf(stderr, "--- Serial @%u baud: TX blocked %llu us in %u writes, RX throttled %llu us\n",
+					Board.Uart0.GetBaudRate(), static_cast<unsigned long long>(timing.TxBlockedMicros), timing.TxBlockedWrites,
+					static_cast<unsigned long long>(timing.RxThrottledMicros));
+			}
+
+			const ArduinoTimer::Statistics timer = Board.Timer.getStatistics();
+			if (timer.Count > 0)
+			{
+				fprintf(stderr, "--- Timer1 %u ISRs (%u missed), latency min/avg/max %u/%u/%u us\n",
+					timer.Count, timer.Missed, timer.LatencyMin, timer.LatencyAverage, timer.LatencyMax);
+			}
+		}
+
+		// Streams raw TX spans to stdout, flushing when the sketch goes quiet.
+		void PumpOutput()
+		{
+			while (true)
+			{
+				const uint32_t txId = Board.Uart0.GetTxId();
+				const size_t written = Board.Uart0.drainTxRaw([this](const uint8_t* data, const size_t length)
+					{
+						fwrite(data, 1, length, stdout);
+					});
+				BytesOut += written;
+
+				if (written > 0)
+					continue;
+
+				fflush(stdout);
+				if (!OutputRunning.load())
+					break;
+				Board.Uart0.waitForTx(txId, PollMillis);
+			}
+
+			// Final drain, after the host has stopped writing.
+			BytesOut += Board.Uart0.drainTxRaw([](const uint8_t* data, const size_t length)
+				{
+					fwrite(data, 1, length, stdout);
+				});
+		}
+
+		// Feeds stdin to Serial RX in chunks, until EOF or the run ends.
+		// Waits for the sketch's Serial.begin(), as the host's reset flushes anything received before.
+		void PumpInput()
+		{
+			while (!Board.Uart0 && OutputRunning.load())
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+			char buffer[InputChunkSize];
+			while (OutputRunning.load())
+			{
+				const size_t length = ReadInput(buffer, sizeof(buffer));
+				if (length == SIZE_MAX)
+					break;
+				if (length > 0)
+					BytesIn += Board.Uart0.Rx(buffer, length);
+			}
+			InputEnded = true;
+		}
+
+		// Returns bytes read, 0 if none yet, SIZE_MAX at end of input.
+		static size_t ReadInput(char* buffer, const size_t size)
+		{
+#if defined(_WIN32)
+			const size_t length = fread(buffer, 1, size, stdin);
+			return length > 0 ? length : SIZE_MAX;
+#else
+			pollfd input{};
+			input.fd = STDIN_FILENO;
+			input.events = POLLIN;
+			const int ready = poll(&input, 1, static_cast<int>(PollMillis));
+			if (ready <= 0)
+				return 0;
+
+			const ssize_t length = read(STDIN_FILENO, buffer, size);
+			return length > 0 ? static_cast<size_t>(length) : SIZE_MAX;
+#endif
+		}
+
+		static bool ParseNumber(const int argc, char** argv, int& index, uint32_t& value)
+		{
+			if (index + 1 >= argc)
+				return false;
+
+			char* end = nullptr;
+			const unsigned long parsed = strtoul(argv[++index], &end, 10);
+			if (end == argv[index] || *end != '\0')
+				return false;
+
+			value = static_cast<uint32_t>(parsed);
+			return true;
+		}
+
+		static bool Usage(const char* name)
+		{
+			fprintf(stderr, "Usage: %s [-d|--duration MS] [-n|--iterations N] [--no-input] [--exit-on-eof] [-q|--quiet]\n", name);
+			return false;
+		}
+
+		static std::atomic<bool>& Interrupted()
+		{
+			static std::atomic<bool> interrupted{ false };
+			return interrupted;
+		}
+
+		static void OnSignal(int)
+		{
+			Interrupted().store(true);
+		}
+	};
+}
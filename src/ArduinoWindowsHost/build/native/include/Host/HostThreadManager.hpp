@@ -63,12 +63,20 @@ namespace ArduinoWindowsHost
 	private:
 		HostThread ThreadManager{};
 
+		// Board shared by every host this manager starts, so UI bindings to its ports and pins survive restarts.
+		Hal::TemplateHalContext<typename HostType::BoardProfile> Context{};
+
 	public:
 		HostType* Host = nullptr;
 
 	public:
 		TemplateHostManager() {}
 
+		Hal::HalContext& GetHal()
+		{
+			return Context;
+		}
+
 		bool isRunning()
 		{
 			return (Host != nullptr && Host->isRunning());
@@ -83,6 +91,7 @@ namespace ArduinoWindowsHost
 				Host = nullptr;
 			}
 			Host = new HostType();
+			Host->SetHal(Context);
 			ThreadManager.Start(*Host);
 		}
 
@@ -7,21 +7,52 @@
 #include <functional>
 #include <future>
 #include <condition_variable>
+#include <string>
+#include <string.h>
+#include <memory>
 
 #include "../HAL/Arduino.h"
 
 namespace ArduinoWindowsHost
 {
+	// When the host calls the sketch's serial callbacks.
+	enum class SerialEventMode : uint8_t
+	{
+		Change,		// serialEvent() whenever Serial input changes, as often as once per received chunk (default).
+		Line,		// serialEvent() once per batch of completed lines; the sketch reads them.
+		LineSpan	// serialLineEvent() once per line, handed over in place and consumed by the host.
+	};
+
 	// LoopHost
 	// - Provides an Arduino-like lifecycle: setup -> loop (repeated) -> setdown.
 	// - Hosts a single-threaded "loop" and a dispatch queue to marshal work onto that loop.
 	// - Thread-safe start/stop flags guarded by an internal mutex.
+	// - Runs on its own emulated board (Hal::HalContext), bound to the loop thread, so hosts don't share Serial/pins/timers.
 	class LoopHost
 	{
+	public:
+		// Board dimensions of the owned HalContext, see TemplateLoopHost.
+		using BoardProfile = Hal::DefaultBoardProfile;
+
 	protected:
 		// Tracks RX state changes to fire serialEvent when Serial input changes.
 		volatile uint32_t SerialStateId = UINT32_MAX;
 
+	private:
+		// Serial event mode and line event settings (loop thread).
+		SerialEventMode EventMode = SerialEventMode::Change;
+		char LineTerminator = '\n';
+		size_t LineThreshold = 0;
+		uint32_t LineTimeoutMillis = 0;
+
+		// Line event state: terminators already handled, and when unterminated input started waiting.
+		uint32_t SerialTerminators = 0;
+		uint32_t SerialPendingSince = 0;
+		bool SerialPending = false;
+
+		// Holds a line split by the RX ring wrap-around, for serialLineEvent().
+		std::string LineBuffer{};
+
 	private:
 		// Lifetime flags (guarded by mutex).
 		volatile bool cancelled = false;
@@ -30,6 +61,11 @@ namespace ArduinoWindowsHost
 		// Guards access to running/cancelled flags.
 		std::mutex mutex{};
 
+	private:
+		// Emulated board, created on first use unless SetHal() provided one (guarded by mutex, fixed while running).
+		std::unique_ptr<Hal::HalContext> OwnedHal{};
+		Hal::HalContext* HalInstance = nullptr;
+
 	private:
 		// Dispatch queue to run work on the host loop thread.
 		std::mutex dispatchMutex{};
@@ -51,12 +87,61 @@ namespace ArduinoWindowsHost
 		// Arduino-style serial event method, runs when serial data is received.
 		virtual void serialEvent() {}
 
+		// Line event method for SerialEventMode::LineSpan, runs once per received line.
+		// line excludes the terminator (and a '\r' before a '\n' terminator) and is only valid during the call.
+		// The host consumes it from Serial afterwards, so don't read Serial from here.
+		virtual void serialLineEvent(const char* line, const size_t length) {}
+
 		// Opposite of setup, runs once at stop.
 		virtual void setdown() {}
 
+		// Creates the owned board, unless SetHal() provided one.
+		virtual Hal::HalContext* CreateHal() const
+		{
+			return new Hal::TemplateHalContext<BoardProfile>();
+		}
+
 	public:
 		LoopHost() = default;
 
+		// Uses an external board instead of an owned one, so its state outlives the host. Call before starting.
+		void SetHal(Hal::HalContext& context)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			OwnedHal.reset();
+			HalInstance = &context;
+		}
+
+		// This host's board. On the loop thread, the Arduino API (Serial, digitalWrite(), ...) resolves to it.
+		Hal::HalContext& GetHal()
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (HalInstance == nullptr)
+			{
+				OwnedHal.reset(CreateHal());
+				HalInstance = OwnedHal.get();
+			}
+			return *HalInstance;
+		}
+
+		/// <summary>
+		/// Selects when serialEvent()/serialLineEvent() run, call from setup() or before starting.
+		/// Line modes fire on terminator, or on unterminated input once threshold bytes are waiting
+		/// (0 for none, a full RX ring always counts) or after it waited timeoutMillis (0 for never).
+		/// </summary>
+		void SetSerialEventMode(const SerialEventMode mode, const char terminator = '\n', const size_t threshold = 0, const uint32_t timeoutMillis = 0)
+		{
+			EventMode = mode;
+			LineTerminator = terminator;
+			LineThreshold = threshold;
+			LineTimeoutMillis = timeoutMillis;
+
+			Hal::ArduinoSerialPort& serial = GetHal().Uart0;
+			serial.SetRxTerminator(mode == SerialEventMode::Change ? -1 : static_cast<uint8_t>(terminator));
+			SerialTerminators = serial.GetRxTerminators();
+			SerialPending = false;
+		}
+
 	public:
 		// Returns true while the host is running.
 		bool isRunning()
@@ -75,6 +160,9 @@ namespace ArduinoWindowsHost
 		// Main loop entry point. Sets up, runs until cancelled, then tears down.
 		void OnRun()
 		{
+			Hal::HalContext& hal = GetHal();
+			Hal::HalContext::Scope binding(hal);
+
 			setRunning(true);
 
 			try
@@ -83,25 +171,37 @@ namespace ArduinoWindowsHost
 
 				Hal::reset();
 
-				SerialStateId = Serial.GetRxId();
+				SerialStateId = hal.Uart0.GetRxId();
+				SetSerialEventMode(EventMode, LineTerminator, LineThreshold, LineTimeoutMillis);
 
 				setup();
 
 				while (!isCancelled())
 				{
 					// Check for serial events.
-					if (Serial)
+					if (hal.Uart0)
 					{
-						const uint32_t serialStateId = Serial.GetRxId();
-						if (serialStateId != SerialStateId)
+						if (EventMode == SerialEventMode::Change)
 						{
-							SerialStateId = serialStateId;
-							serialEvent();
+							const uint32_t serialStateId = hal.Uart0.GetRxId();
+							if (serialStateId != SerialStateId)
+							{
+								SerialStateId = serialStateId;
+								serialEvent();
+							}
+						}
+						else
+						{
+							checkSerialLines();
 						}
 					}
 
 					// Run the main loop.
 					loop();
+					hal.Iteration.fetch_add(1, std::memory_order_relaxed);
+
+					// Commit partial lines left by buffered TX.
+					flushSerialBuffers();
 
 					// Run externally posted work.
 					drainDispatchQueue();
@@ -112,9 +212,19 @@ namespace ArduinoWindowsHost
 			}
 			catch (...)
 			{
-				Serial.println("Exception!");
+				hal.Uart0.println("Exception!");
 			}
 
+			flushSerialBuffers();
+
+			// Emulated ISRs must not outlive the sketch.
+			interrupts();
+			hal.Timer.detachInterrupt();
+
+			// Release RX producers blocked on backpressure.
+			for (uint8_t i = 0; i < hal.GetUartCount(); i++)
+				hal.GetUart(i).end();
+
 			setRunning(false);
 		}
 
@@ -204,6 +314,96 @@ namespace ArduinoWindowsHost
 			}
 		}
 
+		// Line modes: fires on new terminators (counted by Serial as bytes arrive), or on threshold/timeout.
+		// Costs a counter read per loop while no line is pending.
+		void checkSerialLines()
+		{
+			Hal::ArduinoSerialPort& serial = HalInstance->Uart0;
+			const uint32_t terminators = serial.GetRxTerminators();
+			bool partial = false;
+			if (terminators == SerialTerminators)
+			{
+				const size_t available = static_cast<size_t>(serial.available());
+				if (available == 0)
+				{
+					SerialPending = false;
+					return;
+				}
+
+				const uint32_t now = millis();
+				if (!SerialPending)
+				{
+					SerialPending = true;
+					SerialPendingSince = now;
+				}
+
+				partial = (LineThreshold > 0 && available >= LineThreshold)
+					|| available >= serial.GetRxCapacity()
+					|| (LineTimeoutMillis > 0 && (now - SerialPendingSince) >= LineTimeoutMillis);
+				if (!partial)
+					return;
+			}
+
+			SerialTerminators = terminators;
+			SerialPending = false;
+
+			if (EventMode == SerialEventMode::Line)
+				serialEvent();
+			else
+				dispatchSerialLines(partial);
+		}
+
+		// Hands each complete line to serialLineEvent() in place, then consumes it.
+		// With partial, unterminated input left over is handed over as one more line, unless complete lines
+		// came first: bytes are visible before their terminators are counted, so the leftover may still be arriving.
+		void dispatchSerialLines(const bool partial)
+		{
+			uint8_t* first;
+			uint8_t* second;
+			size_t firstLength, secondLength;
+			size_t ready;
+			bool dispatched = false;
+			Hal::ArduinoSerialPort& serial = HalInstance->Uart0;
+			while ((ready = serial.peekRx(first, firstLength, second, secondLength)) > 0)
+			{
+				size_t length = ready;
+				const void* found = memchr(first, LineTerminator, firstLength);
+				if (found != nullptr)
+					length = static_cast<size_t>(static_cast<const uint8_t*>(found) - first);
+				else if ((found = memchr(second, LineTerminator, secondLength)) != nullptr)
+					length = firstLength + static_cast<size_t>(static_cast<const uint8_t*>(found) - second);
+				else if (!partial || dispatched)
+					return;
+
+				const size_t consumed = found != nullptr ? length + 1 : length;
+
+				const char* line = reinterpret_cast<const char*>(first);
+				if (length > firstLength)
+				{
+					LineBuffer.assign(reinterpret_cast<const char*>(first), firstLength);
+					LineBuffer.append(reinterpret_cast<const char*>(second), length - firstLength);
+					line = LineBuffer.data();
+				}
+
+				if (found != nullptr && LineTerminator == '\n' && length > 0 && line[length - 1] == '\r')
+					length--;
+
+				serialLineEvent(line, length);
+				serial.consumeRx(consumed);
+
+				if (found == nullptr)
+					return;
+				dispatched = true;
+			}
+		}
+
+		// Commits partial lines held in the loop thread's buffered TX (no-op when unbuffered).
+		void flushSerialBuffers()
+		{
+			for (uint8_t i = 0; i < HalInstance->GetUartCount(); i++)
+				HalInstance->GetUart(i).flushTxBuffer();
+		}
+
 		// Internal helper to set the running flag under lock.
 		void setRunning(const bool state)
 		{
@@ -211,4 +411,21 @@ namespace ArduinoWindowsHost
 			running = state;
 		}
 	};
-}
\ No newline at end of file
+
+	/// <summary>
+	/// LoopHost on a board dimensioned by Profile (see Hal::DefaultBoardProfile), e.g. Hal::CompactBoardProfile
+	/// for many small hosts per process. Addons stack on top of it as on LoopHost.
+	/// </summary>
+	template<typename Profile>
+	class TemplateLoopHost : public LoopHost
+	{
+	public:
+		using BoardProfile = Profile;
+
+	protected:
+		Hal::HalContext* CreateHal() const override
+		{
+			return new Hal::TemplateHalContext<Profile>();
+		}
+	};
+}